@@ -3,23 +3,330 @@
  * @brief Implementation of the ArrayList functions.
  */
 
+#define _GNU_SOURCE // MAP_ANONYMOUS, mremap
+
 #include "ArrayList.h"
-#include <stdio.h>
+#include "ArrayListInternal.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+static void *libc_allocate(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void *libc_reallocate(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    (void)ctx;
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static void libc_deallocate(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    (void)size;
+    free(ptr);
+}
+
+#ifdef __GLIBC__
+static size_t libc_usable_size(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    (void)size;
+    return malloc_usable_size(ptr);
+}
+#endif
+
+static const ArrayListAllocator LIBC_ALLOCATOR = {
+    .allocate = libc_allocate,
+    .reallocate = libc_reallocate,
+    .deallocate = libc_deallocate,
+    .ctx = NULL,
+#ifdef __GLIBC__
+    .usable_size = libc_usable_size,
+#endif
+};
+
+/**
+ * @brief Returns the default allocator.
+ *
+ * The default allocator forwards to `malloc`, `realloc` and `free`, and
+ * reports usable sizes with `malloc_usable_size` where glibc provides it.
+ *
+ * @return Pointer to the default allocator.
+ */
+const ArrayListAllocator* default_allocator(void) {
+    return &LIBC_ALLOCATOR;
+}
+
+static size_t page_size(void) {
+    static size_t cached = 0;
+    if (cached == 0) cached = (size_t)sysconf(_SC_PAGESIZE);
+    return cached;
+}
+
+static size_t round_to_page(const size_t bytes) {
+    const size_t page = page_size();
+    return (bytes + page - 1) & ~(page - 1);
+}
+
+/**
+ * @brief Returns the number of slots kept after the last element for the nullptr terminator.
+ */
+static size_t terminator_slots(const ArrayList *list) {
+    return (list->flags & ARRAYLIST_NO_TERMINATOR) ? 0 : 1;
+}
+
+/**
+ * @brief Returns the size in bytes of a buffer holding `capacity` elements.
+ *
+ * Never returns 0, so that allocators are not asked for empty blocks.
+ * Every allocation size goes through here, so this is where capacities
+ * whose size would overflow are rejected.
+ */
+static size_t buffer_bytes(const ArrayList *list, const size_t capacity) {
+    if (capacity > SIZE_MAX / sizeof(void *) - terminator_slots(list)) THROW_ERROR("capacity too large");
+    const size_t slots = capacity + terminator_slots(list);
+    return (slots > 0 ? slots : 1) * sizeof(void *);
+}
+
+/**
+ * @brief Writes the nullptr terminator after the last element, if the list keeps one.
+ */
+static void terminate(ArrayList *list) {
+    if (terminator_slots(list) != 0) list->arr[list->n] = NULL;
+}
+
+/**
+ * @brief Commits or decommits pages of a reserved buffer.
+ *
+ * Pages up to the one holding slot `capacity` (the terminator) are made
+ * accessible; the rest of the range is returned to the kernel. The capacity
+ * is rounded up to fill the last committed page.
+ */
+static void commit_reserved(ArrayList *list, const size_t capacity) {
+    const size_t committed = (list->length + terminator_slots(list)) * sizeof(void *);
+    const size_t wanted = round_to_page(buffer_bytes(list, capacity));
+    if (wanted > list->extension->reserved) THROW_ERROR("reserved capacity exceeded");
+    if (wanted > committed) {
+        if (mprotect((char *)list->arr + committed, wanted - committed, PROT_READ | PROT_WRITE) != 0) {
+            THROW_ERROR("out of memory");
+        }
+    } else if (wanted < committed) {
+        // Mapping fresh PROT_NONE pages over the tail drops their contents.
+        if (mmap((char *)list->arr + wanted, committed - wanted, PROT_NONE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+            THROW_ERROR("failed to decommit memory");
+        }
+    }
+    list->length = wanted / sizeof(void *) - terminator_slots(list);
+}
+
+/**
+ * @brief Returns how many elements fit in a freshly allocated buffer.
+ *
+ * Allocators round requests up to their size classes; asking them for the
+ * usable size turns that slack into capacity, so the next growth comes later.
+ */
+static size_t usable_capacity(const ArrayList *list, const size_t capacity) {
+    const ArrayListAllocator *allocator = list->allocator;
+    if (allocator->usable_size == NULL) return capacity;
+    const size_t usable = allocator->usable_size(allocator->ctx, list->arr, buffer_bytes(list, capacity));
+    const size_t slots = usable / sizeof(void *) - terminator_slots(list);
+    return slots > capacity ? slots : capacity;
+}
+
+static const ArrayListGrowthPolicy DEFAULT_GROWTH = {
+    .kind = ARRAYLIST_GROWTH_GEOMETRIC,
+    .factor = 2.0,
+};
+
+const ArrayListExtension arraylist_default_extension = {
+    .growth = DEFAULT_GROWTH,
+};
+
+ArrayListExtension *arraylist_ensure_extension(ArrayList *list) {
+    if (list->extension == NULL) {
+        const ArrayListAllocator *allocator = list->allocator;
+        ArrayListExtension *extension = allocator->allocate(allocator->ctx, sizeof(ArrayListExtension));
+        if (extension == NULL) THROW_ERROR("out of memory");
+        *extension = arraylist_default_extension;
+        list->extension = extension;
+    }
+    return list->extension;
+}
+
+/**
+ * @brief Moves the element buffer to a new capacity.
+ *
+ * The caller guarantees that `capacity` is at least the number of elements.
+ */
+static void set_capacity(ArrayList *list, const size_t capacity) {
+    if (list->storage == ARRAYLIST_STORAGE_RESERVED) {
+        commit_reserved(list, capacity);
+        return;
+    }
+    if (list->storage == ARRAYLIST_STORAGE_INLINE || list->storage == ARRAYLIST_STORAGE_BORROWED) {
+        if (capacity <= list->length) return; // Slots the list does not own can neither shrink nor be released
+        // Spill to the allocator; the original slots are left untouched from here on.
+        // Inline slots still count towards the structure's allocation, so remember their size.
+        ArrayListExtension *extension =
+            list->storage == ARRAYLIST_STORAGE_INLINE ? arraylist_ensure_extension(list) : NULL;
+        const ArrayListAllocator *allocator = list->allocator;
+        void **newArr = allocator->allocate(allocator->ctx, buffer_bytes(list, capacity));
+        if (newArr == NULL) THROW_ERROR("out of memory");
+        memcpy(newArr, list->arr, (list->n + terminator_slots(list)) * sizeof(void *));
+        if (extension != NULL) extension->inline_bytes = buffer_bytes(list, list->length);
+        list->arr = newArr;
+        list->storage = ARRAYLIST_STORAGE_HEAP;
+        list->length = usable_capacity(list, capacity);
+        return;
+    }
+#ifdef __linux__
+    const size_t bytes = buffer_bytes(list, capacity);
+    if (list->storage == ARRAYLIST_STORAGE_MAPPED) {
+        const size_t mapped = round_to_page(bytes);
+        void *newArr = mremap(list->arr, list->extension->reserved, mapped, MREMAP_MAYMOVE);
+        if (newArr == MAP_FAILED) THROW_ERROR("out of memory");
+        list->arr = newArr;
+        list->extension->reserved = mapped;
+        list->length = mapped / sizeof(void *) - terminator_slots(list);
+        return;
+    }
+    const size_t mmap_threshold = arraylist_extension(list)->mmap_threshold;
+    if (mmap_threshold != 0 && bytes >= mmap_threshold) {
+        // Copy once into a private mapping; from here on growth moves page tables.
+        const size_t mapped = round_to_page(bytes);
+        void *newArr = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (newArr == MAP_FAILED) THROW_ERROR("out of memory");
+        memcpy(newArr, list->arr, (list->n + terminator_slots(list)) * sizeof(void *));
+        const ArrayListAllocator *allocator = list->allocator;
+        allocator->deallocate(allocator->ctx, list->arr, buffer_bytes(list, list->length));
+        list->arr = newArr;
+        list->storage = ARRAYLIST_STORAGE_MAPPED;
+        list->extension->reserved = mapped;
+        list->length = mapped / sizeof(void *) - terminator_slots(list);
+        return;
+    }
+#endif
+    const ArrayListAllocator *allocator = list->allocator;
+    void **newArr = allocator->reallocate(allocator->ctx, list->arr,
+                                          buffer_bytes(list, list->length),
+                                          buffer_bytes(list, capacity));
+    if (newArr == NULL) THROW_ERROR("out of memory");
+    list->arr = newArr;
+    list->length = usable_capacity(list, capacity);
+}
+
+/**
+ * @brief Returns the smallest jemalloc-style size class strictly above `bytes`.
+ *
+ * Classes are spaced four to a doubling: 8, 16, 32, 48, 64, 80, 96, 112,
+ * 128, 160, 192, 224, 256, 320, ...
+ */
+static size_t next_size_class(const size_t bytes) {
+    if (bytes < 16) return 16;
+    size_t group = 16;
+    while (group * 2 <= bytes) group *= 2;
+    const size_t spacing = group < 64 ? 16 : group / 4;
+    return (bytes / spacing + 1) * spacing;
+}
 
 /**
- * @brief Macro for throwing an error and terminating the program.
+ * @brief Grows the buffer so that it can hold at least `required` elements.
  *
- * This macro prints an error message to `stderr` with the function name
- * where the error occurred, and then exits the program with a failure code.
+ * The new capacity is chosen by the list's growth policy and capped at the
+ * reservation of a reserved list.
+ */
+static void grow(ArrayList *list, const size_t required) {
+    const ArrayListGrowthPolicy *policy = &arraylist_extension(list)->growth;
+    const size_t length = list->length;
+    size_t capacity;
+    switch (policy->kind) {
+        case ARRAYLIST_GROWTH_ADDITIVE:
+            // Saturate on overflow so that buffer_bytes() rejects the capacity.
+            capacity = policy->increment <= SIZE_MAX - length ? length + policy->increment : SIZE_MAX;
+            break;
+        case ARRAYLIST_GROWTH_SIZE_CLASS:
+            // Capacity is measured in slots, the size class in bytes including the terminator.
+            capacity = next_size_class(buffer_bytes(list, length)) / sizeof(void *) - terminator_slots(list);
+            break;
+        case ARRAYLIST_GROWTH_CALLBACK:
+            capacity = policy->callback(length, required, policy->ctx);
+            break;
+        case ARRAYLIST_GROWTH_GEOMETRIC:
+        default: {
+            // Converting a double beyond SIZE_MAX is undefined; saturate instead.
+            const double grown = (double)length * policy->factor;
+            capacity = grown < (double)SIZE_MAX ? (size_t)grown + 1 : SIZE_MAX;
+            break;
+        }
+    }
+    if (capacity < required) capacity = required;
+    if (list->storage == ARRAYLIST_STORAGE_RESERVED) {
+        // Growth stops at the reservation instead of overshooting it.
+        const size_t max_length = list->extension->reserved / sizeof(void *) - terminator_slots(list);
+        if (required > max_length) THROW_ERROR("reserved capacity exceeded");
+        if (capacity > max_length) capacity = max_length;
+    }
+    set_capacity(list, capacity);
+}
+
+/**
+ * @brief Sets every field of a new ArrayList except `arr` and `length`.
+ */
+static void init_fields(ArrayList *list, const ArrayListAllocator *allocator, const unsigned flags,
+                        const ArrayListStorage storage) {
+    list->n = 0;
+    list->flags = flags;
+    list->storage = storage;
+    list->allocator = allocator;
+    list->extension = NULL;
+}
+
+/**
+ * @brief Makes room for `count` more elements, growing at most once.
+ */
+static void ensure_room(ArrayList *list, const size_t count) {
+    if (count > SIZE_MAX / sizeof(void *) - list->n) THROW_ERROR("capacity too large");
+    if (list->n + count > list->length) {
+        grow(list, list->n + count);
+    }
+}
+
+/**
+ * @brief Records that elements were added or reordered arbitrarily.
  *
- * @param msg A string describing the error.
+ * Drops the sorted flag; operations that keep the order intact do not
+ * call this.
+ */
+static void order_changed(ArrayList *list) {
+    if (list->extension != NULL) list->extension->sorted_by = NULL;
+}
+
+/**
+ * @brief Marks the search index stale so that it is rebuilt before its next use.
+ */
+static void invalidate_search_index(ArrayList *list) {
+    ArrayListSearchIndex *index = arraylist_extension(list)->search_index;
+    if (index != NULL) index->stale = true;
+}
+
+/**
+ * @brief Records that elements were removed or moved in bulk.
  *
- * @note This macro uses `fprintf` and `exit`, so it immediately terminates
- *       the program. Use with caution in critical or multi-threaded contexts.
+ * Marks the search index stale and rebuilds the hash index right away,
+ * so that find() stays read-only. Insertions update the hash index
+ * incrementally instead.
  */
-#define THROW_ERROR(msg) fprintf(stderr, "[ERROR] %s in function: %s\n", msg, __func__), exit(EXIT_FAILURE)
+static void contents_changed(ArrayList *list) {
+    invalidate_search_index(list);
+    arraylist_hash_rebuild(list);
+}
 
 /**
  * @brief Initializes an ArrayList.
@@ -30,29 +337,169 @@
  * @return Pointer to the initialized ArrayList.
  */
 ArrayList* init(const size_t length) {
-    ArrayList *list = malloc(sizeof(ArrayList));
+    return init_with_allocator(length, NULL);
+}
+
+/**
+ * @brief Initializes an ArrayList with a custom allocator.
+ *
+ * Both the ArrayList structure and its element buffer are obtained from
+ * `allocator`. The allocator must outlive the list.
+ *
+ * @param length Initial capacity of the ArrayList.
+ * @param allocator Allocator to use, or NULL for the default allocator.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_with_allocator(const size_t length, const ArrayListAllocator *allocator) {
+    return init_ex(length, allocator, 0);
+}
+
+/**
+ * @brief Initializes an ArrayList with a custom allocator and flags.
+ *
+ * @param length Initial capacity of the ArrayList.
+ * @param allocator Allocator to use, or NULL for the default allocator.
+ * @param flags Bitwise OR of `ARRAYLIST_*` flags.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_ex(const size_t length, const ArrayListAllocator *allocator, const unsigned flags) {
+    if (allocator == NULL) allocator = &LIBC_ALLOCATOR;
+    ArrayList *list = allocator->allocate(allocator->ctx, sizeof(ArrayList));
     if (list == NULL) THROW_ERROR("out of memory");
-    list->arr = calloc(length + 1, sizeof(void *)); // +1 for the nullptr terminator
+    init_fields(list, allocator, flags, ARRAYLIST_STORAGE_HEAP);
+    list->arr = allocator->allocate(allocator->ctx, buffer_bytes(list, length));
     if (list->arr == NULL) {
-        free(list);
+        allocator->deallocate(allocator->ctx, list, sizeof(ArrayList));
         THROW_ERROR("out of memory");
     }
-    list->n = 0;
-    list->length = length;
-    list->arr[list->n] = NULL; // Initial terminator
+    list->length = usable_capacity(list, length);
+    terminate(list); // Initial terminator
+    return list;
+}
+
+/**
+ * @brief Initializes an ArrayList whose first elements live inside the structure.
+ *
+ * The structure and `inline_length` element slots are obtained with a
+ * single allocation, so short lists cost one `malloc` instead of two and
+ * keep their elements right after the structure. The elements move to a
+ * separate heap buffer only once the list grows beyond `inline_length`.
+ *
+ * The first inline slot starts within 64 bytes of the structure, so a
+ * cache-line-aligned allocation keeps `n`, `length` and the first slots
+ * on one line. For lists that need no allocation at all, declare an
+ * ARRAYLIST_SMALL variable instead.
+ *
+ * @param inline_length Number of elements stored inline.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_small(const size_t inline_length) {
+    if (inline_length >= (SIZE_MAX - sizeof(ArrayList)) / sizeof(void *)) THROW_ERROR("inline capacity too large");
+    ArrayList *list = LIBC_ALLOCATOR.allocate(NULL, sizeof(ArrayList) + (inline_length + 1) * sizeof(void *)); // +1 for the nullptr terminator
+    if (list == NULL) THROW_ERROR("out of memory");
+    init_fields(list, &LIBC_ALLOCATOR, 0, ARRAYLIST_STORAGE_INLINE);
+    list->arr = (void **)(list + 1);
+    list->length = inline_length;
+    terminate(list); // Initial terminator
+    return list;
+}
+
+/**
+ * @brief Initializes a caller-owned ArrayList structure in place.
+ *
+ * Nothing is allocated when `buffer` is given: the list uses it until it
+ * outgrows it and then migrates to a heap buffer. freeArrayList() releases
+ * only what the list allocated itself, never `list` or `buffer`, and must
+ * still be called to release a buffer obtained after migrating.
+ *
+ * @param list Pointer to the caller-owned structure, e.g. a local variable.
+ * @param buffer Caller-owned initial buffer such as a stack array, or NULL
+ *               to allocate one from the default allocator.
+ * @param buffer_length Number of slots in `buffer`, one of which holds the
+ *                      nullptr terminator; with a NULL `buffer`, the
+ *                      initial capacity.
+ * @return `list`.
+ */
+ArrayList* init_in_place(ArrayList *list, void **buffer, const size_t buffer_length) {
+    if (buffer == NULL) {
+        init_fields(list, &LIBC_ALLOCATOR, 0, ARRAYLIST_STORAGE_HEAP);
+        list->arr = LIBC_ALLOCATOR.allocate(NULL, buffer_bytes(list, buffer_length));
+        if (list->arr == NULL) THROW_ERROR("out of memory");
+        list->length = usable_capacity(list, buffer_length);
+    } else {
+        if (buffer_length == 0) THROW_ERROR("buffer has no room for the terminator");
+        init_fields(list, &LIBC_ALLOCATOR, 0, ARRAYLIST_STORAGE_BORROWED);
+        list->arr = buffer;
+        list->length = buffer_length - 1; // -1 for nullptr terminator
+    }
+    list->flags |= ARRAYLIST_BORROWED_STRUCTURE;
+    terminate(list); // Initial terminator
+    return list;
+}
+
+/**
+ * @brief Initializes an ArrayList backed by a reserved virtual address range.
+ *
+ * Reserves enough address space for `max_length` elements up front and
+ * commits pages only as the list grows, so growing never copies and `arr`
+ * keeps the same address for the lifetime of the list. Growing beyond
+ * `max_length` is an error.
+ *
+ * @param length Initial capacity of the ArrayList.
+ * @param max_length Maximum capacity the ArrayList may ever reach.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_reserved(const size_t length, const size_t max_length) {
+    if (length > max_length) THROW_ERROR("initial capacity exceeds maximum capacity");
+    if (max_length >= SIZE_MAX / sizeof(void *)) THROW_ERROR("maximum capacity too large");
+    ArrayList *list = LIBC_ALLOCATOR.allocate(NULL, sizeof(ArrayList));
+    if (list == NULL) THROW_ERROR("out of memory");
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    const size_t reserved = round_to_page((max_length + 1) * sizeof(void *));
+    void *range = mmap(NULL, reserved, PROT_NONE, flags, -1, 0);
+    if (range == MAP_FAILED) {
+        LIBC_ALLOCATOR.deallocate(NULL, list, sizeof(ArrayList));
+        THROW_ERROR("failed to reserve address space");
+    }
+    init_fields(list, &LIBC_ALLOCATOR, 0, ARRAYLIST_STORAGE_RESERVED);
+    list->arr = range;
+    list->length = (size_t)-1; // Nothing committed yet: (length + 1) slots == 0 bytes
+    arraylist_ensure_extension(list)->reserved = reserved;
+    commit_reserved(list, length);
+    terminate(list); // Initial terminator
     return list;
 }
 
 /**
  * @brief Frees the memory used by an ArrayList.
  *
- * Frees both the dynamic array and the ArrayList structure itself.
+ * Frees both the dynamic array and the ArrayList structure itself, except
+ * for memory the list does not own (see init_in_place()).
  *
  * @param list Pointer to the ArrayList.
  */
 void freeArrayList(ArrayList *list) {
-    free(list->arr);
-    free(list);
+    const ArrayListAllocator *allocator = list->allocator;
+    free_search_index(list);
+    free_hash_index(list);
+    free_bloom_filter(list);
+    if (list->storage == ARRAYLIST_STORAGE_RESERVED || list->storage == ARRAYLIST_STORAGE_MAPPED) {
+        munmap(list->arr, list->extension->reserved);
+    } else if (list->storage == ARRAYLIST_STORAGE_HEAP) {
+        allocator->deallocate(allocator->ctx, list->arr, buffer_bytes(list, list->length));
+    }
+    // Inline slots are sized by the capacity while the list still uses them.
+    const size_t inline_bytes = list->storage == ARRAYLIST_STORAGE_INLINE ? buffer_bytes(list, list->length)
+                                                                          : arraylist_extension(list)->inline_bytes;
+    if (list->extension != NULL) {
+        allocator->deallocate(allocator->ctx, list->extension, sizeof(ArrayListExtension));
+    }
+    if (!(list->flags & ARRAYLIST_BORROWED_STRUCTURE)) {
+        allocator->deallocate(allocator->ctx, list, sizeof(ArrayList) + inline_bytes);
+    }
 }
 
 /**
@@ -62,12 +509,67 @@ void freeArrayList(ArrayList *list) {
  * @param element Pointer to the element to add.
  */
 void push_back(ArrayList *list, const void *element) {
+    int (*sorted_by)(const void *, const void *) = arraylist_extension(list)->sorted_by;
+    if (sorted_by != NULL && list->n > 0 && sorted_by(list->arr[list->n - 1], element) > 0) {
+        order_changed(list);
+    }
     if (list->n == list->length) {
-        resize(list, list->length * 2 + 1);
+        grow(list, list->n + 1);
     }
     list->arr[list->n] = (void *)element;
     list->n++;
-    list->arr[list->n] = NULL;
+    invalidate_search_index(list);
+    arraylist_hash_inserted(list, list->n - 1);
+    arraylist_bloom_add(list, (const void *const *)&element, 1);
+    terminate(list);
+}
+
+/**
+ * @brief Adds several elements to the end of the ArrayList.
+ *
+ * Grows at most once and copies all the pointers in one block.
+ * `elements` may point into the list itself, e.g. `&list->arr[i]`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param elements Array of `count` element pointers to add.
+ * @param count Number of elements to add.
+ */
+void push_back_many(ArrayList *list, const void **elements, const size_t count) {
+    if (count == 0) return;
+    // Growing may move the buffer; remember where a slice of the list itself started.
+    const uintptr_t start = (uintptr_t)elements - (uintptr_t)list->arr;
+    const bool aliased = (uintptr_t)elements >= (uintptr_t)list->arr && start < list->n * sizeof(void *);
+    ensure_room(list, count);
+    if (aliased) elements = (const void **)((uintptr_t)list->arr + start);
+    order_changed(list);
+    memcpy(&list->arr[list->n], elements, count * sizeof(void *));
+    list->n += count;
+    invalidate_search_index(list);
+    arraylist_hash_inserted_range(list, list->n - count, count);
+    arraylist_bloom_add(list, (const void *const *)&list->arr[list->n - count], count);
+    terminate(list);
+}
+
+/**
+ * @brief Adds all the elements of another ArrayList to the end of an ArrayList.
+ *
+ * `dst` and `src` may be the same list.
+ *
+ * @param dst Pointer to the ArrayList to extend.
+ * @param src Pointer to the ArrayList whose elements are added.
+ */
+void append_list(ArrayList *dst, const ArrayList *src) {
+    const size_t count = src->n;
+    if (count == 0) return;
+    ensure_room(dst, count);
+    order_changed(dst);
+    // Read src->arr only after growing, in case src is dst and the buffer moved.
+    memcpy(&dst->arr[dst->n], src->arr, count * sizeof(void *));
+    dst->n += count;
+    invalidate_search_index(dst);
+    arraylist_hash_inserted_range(dst, dst->n - count, count);
+    arraylist_bloom_add(dst, (const void *const *)&dst->arr[dst->n - count], count);
+    terminate(dst);
 }
 
 /**
@@ -80,8 +582,10 @@ void pop_back(ArrayList *list) {
         fprintf(stderr, "[ERROR] Empty list in function: %s\n", __func__);
         return;
     }
+    invalidate_search_index(list);
+    arraylist_hash_removing(list, list->n - 1);
     list->n--;
-    list->arr[list->n] = NULL;
+    terminate(list);
 }
 
 /**
@@ -93,10 +597,55 @@ void pop_back(ArrayList *list) {
  */
 void shrink_to_fit(ArrayList *list) {
     if (list->n == list->length) return; // Already optimal
-    void **newArr = realloc(list->arr, (list->n + 1) * sizeof(void *));
-    if (newArr == NULL) THROW_ERROR("out of memory");
-    list->arr = newArr;
-    list->length = list->n;
+    set_capacity(list, list->n);
+}
+
+/**
+ * @brief Sets the buffer size above which the ArrayList uses its own mapping.
+ *
+ * Once a resize needs at least `bytes` bytes, the element buffer is moved
+ * into a private anonymous mapping, and later resizes use `mremap` so the
+ * kernel remaps pages instead of copying them. Only effective on Linux;
+ * elsewhere the threshold is recorded but ignored.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param bytes Threshold in bytes, or 0 to disable.
+ */
+void set_mmap_threshold(ArrayList *list, const size_t bytes) {
+    if (bytes == 0 && list->extension == NULL) return; // Already disabled
+    arraylist_ensure_extension(list)->mmap_threshold = bytes;
+}
+
+/**
+ * @brief Sets the growth policy of the ArrayList.
+ *
+ * The default policy is geometric with a factor of 2, growing a full list
+ * of capacity `length` to `length * 2 + 1`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param policy Policy to copy into the list, or NULL to restore the default.
+ */
+void set_growth_policy(ArrayList *list, const ArrayListGrowthPolicy *policy) {
+    if (policy == NULL) {
+        if (list->extension != NULL) list->extension->growth = DEFAULT_GROWTH;
+        return;
+    }
+    switch (policy->kind) {
+        case ARRAYLIST_GROWTH_GEOMETRIC:
+            if (!(policy->factor > 1.0)) THROW_ERROR("growth factor must be greater than 1");
+            break;
+        case ARRAYLIST_GROWTH_ADDITIVE:
+            if (policy->increment == 0) THROW_ERROR("growth increment must be positive");
+            break;
+        case ARRAYLIST_GROWTH_SIZE_CLASS:
+            break;
+        case ARRAYLIST_GROWTH_CALLBACK:
+            if (policy->callback == NULL) THROW_ERROR("growth callback missing");
+            break;
+        default:
+            THROW_ERROR("unknown growth policy");
+    }
+    arraylist_ensure_extension(list)->growth = *policy;
 }
 
 /**
@@ -130,10 +679,20 @@ size_t get_number_of_elements(const ArrayList *list) {
  */
 void resize(ArrayList *list, const size_t size) {
     if (size <= list->n) return;
-    void **newArr = realloc(list->arr, (size + 1) * sizeof(void *)); // +1 for nullptr terminator
-    if (newArr == NULL) THROW_ERROR("out of memory");
-    list->arr = newArr;
-    list->length = size;
+    set_capacity(list, size);
+}
+
+/**
+ * @brief Ensures the ArrayList can hold at least `size` elements.
+ *
+ * Unlike resize(), this never reduces the capacity.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param size Minimum capacity for the ArrayList.
+ */
+void reserve(ArrayList *list, const size_t size) {
+    if (size <= list->length) return;
+    set_capacity(list, size);
 }
 
 /**
@@ -149,13 +708,22 @@ void insert_at(ArrayList *list, const void *element, const size_t index) {
     if (index > list->n) {
         THROW_ERROR("Index out of range");
     }
+    int (*sorted_by)(const void *, const void *) = arraylist_extension(list)->sorted_by;
+    if (sorted_by != NULL &&
+        ((index > 0 && sorted_by(list->arr[index - 1], element) > 0) ||
+         (index < list->n && sorted_by(element, list->arr[index]) > 0))) {
+        order_changed(list);
+    }
     if (list->n == list->length) {
-        resize(list, list->length * 2 + 1);
+        grow(list, list->n + 1);
     }
     memmove(&list->arr[index + 1], &list->arr[index], (list->n - index) * sizeof(void *));
     list->arr[index] = (void *)element;
     list->n++;
-    list->arr[list->n] = NULL;
+    invalidate_search_index(list);
+    arraylist_hash_inserted(list, index);
+    arraylist_bloom_add(list, (const void *const *)&element, 1);
+    terminate(list);
 }
 
 /**
@@ -170,26 +738,240 @@ void remove_at(ArrayList *list, const size_t index) {
     if (index >= list->n) {
         THROW_ERROR("Index out of range");
     }
-    for (size_t i = index; i < list->n - 1; i++) {
-        list->arr[i] = list->arr[i + 1];
+    invalidate_search_index(list);
+    arraylist_hash_removing(list, index);
+    memmove(&list->arr[index], &list->arr[index + 1], (list->n - index - 1) * sizeof(void *));
+    list->n--;
+    terminate(list);
+}
+
+/**
+ * @brief Removes an element by moving the last element into its place.
+ *
+ * Runs in O(1) but does not preserve the order of the elements.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param index Index of the element to remove.
+ */
+void swap_remove_at(ArrayList *list, const size_t index) {
+    if (index >= list->n) {
+        THROW_ERROR("Index out of range");
     }
+    invalidate_search_index(list);
+    arraylist_hash_swap_removing(list, index);
     list->n--;
-    list->arr[list->n] = NULL;
+    if (index != list->n) order_changed(list);
+    list->arr[index] = list->arr[list->n];
+    terminate(list);
+}
+
+/**
+ * @brief Removes every element for which a predicate holds.
+ *
+ * Compacts the surviving elements in a single pass, preserving their order.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param pred Predicate returning true for elements to remove.
+ * @param ctx Context passed to `pred`.
+ * @return Number of elements removed.
+ */
+size_t erase_if(ArrayList *list, bool (*pred)(const void *element, void *ctx), void *ctx) {
+    size_t kept = 0;
+    for (size_t i = 0; i < list->n; i++) {
+        void *element = list->arr[i];
+        if (!pred(element, ctx)) {
+            list->arr[kept++] = element;
+        }
+    }
+    const size_t removed = list->n - kept;
+    list->n = kept;
+    contents_changed(list);
+    terminate(list);
+    return removed;
+}
+
+/**
+ * @brief Removes the elements at a sorted set of indices.
+ *
+ * Moves each run of surviving elements once, so the whole removal is a
+ * single O(n) sweep regardless of how many indices are given.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param sorted_idx Indices to remove, in increasing order. Repeated
+ *                   indices are removed once.
+ * @param k Number of entries in `sorted_idx`.
+ */
+void remove_indices(ArrayList *list, const size_t *sorted_idx, const size_t k) {
+    if (k == 0) return;
+    if (sorted_idx[k - 1] >= list->n) {
+        THROW_ERROR("Index out of range");
+    }
+    size_t dst = sorted_idx[0];
+    for (size_t j = 0; j < k; j++) {
+        if (j + 1 < k && sorted_idx[j + 1] < sorted_idx[j]) {
+            THROW_ERROR("indices not sorted");
+        }
+        // Survivors between this index and the next one (or the end of the list).
+        const size_t run_start = sorted_idx[j] + 1;
+        const size_t run_end = j + 1 < k ? sorted_idx[j + 1] : list->n;
+        if (run_end > run_start) {
+            memmove(&list->arr[dst], &list->arr[run_start], (run_end - run_start) * sizeof(void *));
+            dst += run_end - run_start;
+        }
+    }
+    list->n = dst;
+    contents_changed(list);
+    terminate(list);
+}
+
+/**
+ * @brief Inserts elements at a sorted set of positions.
+ *
+ * Each `sorted_idx[j]` is a position in the list as it was before the
+ * call: `elements[j]` ends up in front of the element that was at that
+ * position, or at the end for `n`. Elements sharing a position keep their
+ * order. The list grows at most once and the insertion is done in a single
+ * backward sweep that moves every existing element once.
+ * `elements` must not point into the list itself.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param sorted_idx Positions in non-decreasing order.
+ * @param elements Array of `k` element pointers to insert.
+ * @param k Number of elements to insert.
+ */
+void insert_indices(ArrayList *list, const size_t *sorted_idx, const void **elements, const size_t k) {
+    if (k == 0) return;
+    if (sorted_idx[k - 1] > list->n) {
+        THROW_ERROR("Index out of range");
+    }
+    for (size_t j = 1; j < k; j++) {
+        if (sorted_idx[j] < sorted_idx[j - 1]) THROW_ERROR("indices not sorted");
+    }
+    ensure_room(list, k);
+    order_changed(list);
+    size_t src_end = list->n;
+    size_t dst_end = list->n + k;
+    for (size_t j = k; j-- > 0;) {
+        // Shift the run of existing elements behind this position, then drop the new one in front.
+        const size_t run = src_end - sorted_idx[j];
+        dst_end -= run;
+        memmove(&list->arr[dst_end], &list->arr[sorted_idx[j]], run * sizeof(void *));
+        list->arr[--dst_end] = (void *)elements[j];
+        src_end = sorted_idx[j];
+    }
+    list->n += k;
+    invalidate_search_index(list);
+    arraylist_hash_inserted_indices(list, sorted_idx, k);
+    arraylist_bloom_add(list, elements, k);
+    terminate(list);
+}
+
+/**
+ * @brief Inserts several elements at a specific index in the ArrayList.
+ *
+ * Grows at most once and shifts the tail with a single `memmove`.
+ * `elements` must not point into the list itself.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param index Position at which to insert the first element.
+ * @param elements Array of `count` element pointers to insert.
+ * @param count Number of elements to insert.
+ */
+void insert_range(ArrayList *list, const size_t index, const void **elements, const size_t count) {
+    if (index > list->n) {
+        THROW_ERROR("Index out of range");
+    }
+    if (count == 0) return;
+    ensure_room(list, count);
+    order_changed(list);
+    memmove(&list->arr[index + count], &list->arr[index], (list->n - index) * sizeof(void *));
+    memcpy(&list->arr[index], elements, count * sizeof(void *));
+    list->n += count;
+    invalidate_search_index(list);
+    arraylist_hash_inserted_range(list, index, count);
+    arraylist_bloom_add(list, elements, count);
+    terminate(list);
+}
+
+/**
+ * @brief Removes the elements in `[first, last)` from the ArrayList.
+ *
+ * Shifts the tail with a single `memmove`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param first Index of the first element to remove.
+ * @param last Index one past the last element to remove.
+ */
+void remove_range(ArrayList *list, const size_t first, const size_t last) {
+    if (first > last || last > list->n) {
+        THROW_ERROR("Index out of range");
+    }
+    memmove(&list->arr[first], &list->arr[last], (list->n - last) * sizeof(void *));
+    list->n -= last - first;
+    contents_changed(list);
+    terminate(list);
 }
 
 /**
  * @brief Finds an element in the ArrayList using a comparator function.
  *
+ * When a Bloom filter was attached with `cmp`, most absent elements are
+ * rejected without scanning. When a hash index was attached with `cmp`,
+ * the lookup takes expected O(1) time; otherwise, when the list is known
+ * to be sorted by `cmp`, a binary search is used.
+ *
  * @param list Pointer to the ArrayList.
  * @param element Pointer to the element to find.
  * @param cmp Comparator function to compare elements.
  * @return Index of the element if found, -1 otherwise.
  */
 ssize_t find(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *)) {
-    for (size_t i = 0; i < list->n; i++) {
-        if (cmp(list->arr[i], element) == 0) {
-            return (ssize_t)i;
+    const ArrayListExtension *extension = arraylist_extension(list);
+    const bool filtered = extension->bloom_filter != NULL && extension->bloom_filter->cmp == cmp;
+    if (filtered && arraylist_bloom_rejects(list, element)) {
+        return -1; // Definitely absent
+    }
+    ssize_t index = -1;
+    if (extension->hash_index != NULL && extension->hash_index->cmp == cmp) {
+        index = arraylist_hash_find(list, element);
+    } else if (cmp != NULL && extension->sorted_by == cmp) {
+        index = binary_find(list, element, cmp);
+    } else {
+        for (size_t i = 0; i < list->n; i++) {
+            if (cmp(list->arr[i], element) == 0) {
+                index = (ssize_t)i;
+                break;
+            }
         }
     }
-    return -1; // Element not found
+    if (filtered && index < 0) {
+        arraylist_bloom_missed(list);
+    }
+    return index;
+}
+
+/**
+ * @brief Notifies the ArrayList that `arr` was modified directly.
+ *
+ * Must be called after writing to `arr` without going through the
+ * ArrayList functions, so that the sorted flag is dropped and the search
+ * index, hash index and Bloom filter are rebuilt.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void mark_modified(ArrayList *list) {
+    arraylist_reordered(list);
+    if (arraylist_extension(list)->bloom_filter != NULL) rebuild_bloom_filter(list);
+}
+
+/**
+ * @brief Records that the elements were permuted in place.
+ *
+ * Drops the sorted flag, marks the search index stale and rebuilds the
+ * hash index. The Bloom filter is kept, since the set of elements did
+ * not change.
+ */
+void arraylist_reordered(ArrayList *list) {
+    order_changed(list);
+    contents_changed(list);
 }
@@ -12,20 +12,166 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 
+/**
+ * @struct ArrayListAllocator
+ * @brief Memory allocator used by an ArrayList.
+ *
+ * Supplies the allocation routines used for both the ArrayList structure
+ * and its element buffer. Every callback receives the `ctx` pointer, and
+ * the sizes of previous allocations are passed back so that allocators
+ * which do not track block sizes can still be used.
+ *
+ * `usable_size` is optional. When present, it reports how many bytes of a
+ * block of `size` requested bytes may actually be used, and the ArrayList
+ * turns that slack into extra capacity.
+ */
+typedef struct ArrayListAllocator {
+    void *(*allocate)(void *ctx, size_t size);                                    /**< Allocates `size` bytes. */
+    void *(*reallocate)(void *ctx, void *ptr, size_t old_size, size_t new_size);  /**< Resizes a block. */
+    void (*deallocate)(void *ctx, void *ptr, size_t size);                         /**< Releases a block. */
+    void *ctx;                                                                      /**< User context. */
+    size_t (*usable_size)(void *ctx, void *ptr, size_t size);                      /**< Usable bytes of a block, or NULL. */
+} ArrayListAllocator;
+
+/**
+ * @enum ArrayListStorage
+ * @brief Describes where the element buffer of an ArrayList lives.
+ */
+typedef enum ArrayListStorage {
+    ARRAYLIST_STORAGE_HEAP,     /**< Buffer obtained from the list's allocator. */
+    ARRAYLIST_STORAGE_RESERVED, /**< Buffer committed on demand inside a reserved virtual range. */
+    ARRAYLIST_STORAGE_MAPPED,   /**< Buffer in its own anonymous mapping, resized with `mremap`. */
+    ARRAYLIST_STORAGE_INLINE,   /**< Buffer allocated together with the ArrayList structure. */
+    ARRAYLIST_STORAGE_BORROWED, /**< Caller-provided buffer, never freed by the list. */
+} ArrayListStorage;
+
+/**
+ * @enum ArrayListGrowthKind
+ * @brief Strategies for choosing the new capacity when an ArrayList is full.
+ */
+typedef enum ArrayListGrowthKind {
+    ARRAYLIST_GROWTH_GEOMETRIC,  /**< Multiply the capacity by `factor`. */
+    ARRAYLIST_GROWTH_ADDITIVE,   /**< Add `increment` slots. */
+    ARRAYLIST_GROWTH_SIZE_CLASS, /**< Grow to the next jemalloc-style size class. */
+    ARRAYLIST_GROWTH_CALLBACK,   /**< Ask `callback` for the new capacity. */
+} ArrayListGrowthKind;
+
+/**
+ * @struct ArrayListGrowthPolicy
+ * @brief Describes how an ArrayList grows when it runs out of capacity.
+ *
+ * Only the fields used by `kind` are read. Whatever the policy returns,
+ * the new capacity is never smaller than what the operation needs.
+ */
+typedef struct ArrayListGrowthPolicy {
+    ArrayListGrowthKind kind; /**< Strategy to use. */
+    double factor;            /**< Growth factor for ARRAYLIST_GROWTH_GEOMETRIC, greater than 1. */
+    size_t increment;         /**< Slots added by ARRAYLIST_GROWTH_ADDITIVE, greater than 0. */
+    size_t (*callback)(size_t length, size_t required, void *ctx); /**< New capacity for ARRAYLIST_GROWTH_CALLBACK. */
+    void *ctx;                /**< Context passed to `callback`. */
+} ArrayListGrowthPolicy;
+
+/**
+ * @brief Flag for init_ex(): do not keep a nullptr terminator after the last element.
+ *
+ * Saves one slot per buffer and one store per mutation. Lists created with
+ * this flag must be iterated by `n`, never by walking `arr` until NULL.
+ */
+#define ARRAYLIST_NO_TERMINATOR 0x1u
+
+/**
+ * @struct ArrayListSearchIndex
+ * @brief Opaque Eytzinger-ordered key index, see build_search_index().
+ */
+typedef struct ArrayListSearchIndex ArrayListSearchIndex;
+
+/**
+ * @struct ArrayListHashIndex
+ * @brief Opaque hash index, see attach_hash_index().
+ */
+typedef struct ArrayListHashIndex ArrayListHashIndex;
+
+/**
+ * @struct ArrayListBloomFilter
+ * @brief Opaque Bloom filter, see attach_bloom_filter().
+ */
+typedef struct ArrayListBloomFilter ArrayListBloomFilter;
+
+/**
+ * @struct ArrayListBloomStats
+ * @brief Lookup counters of a Bloom filter.
+ */
+typedef struct ArrayListBloomStats {
+    size_t lookups;         /**< find() calls that consulted the filter. */
+    size_t rejections;      /**< Lookups answered "absent" by the filter alone. */
+    size_t false_positives; /**< Lookups the filter let through that found nothing. */
+} ArrayListBloomStats;
+
+/**
+ * @struct ArrayListExtension
+ * @brief Opaque rarely used state of an ArrayList: growth policy, mapping
+ *        fields, sorted flag and attached indexes.
+ */
+typedef struct ArrayListExtension ArrayListExtension;
+
 /**
  * @struct ArrayList
  * @brief Represents a generic dynamic array.
  *
  * This structure holds the dynamic array, its size, and its capacity.
+ * Everything else lives behind `extension`, which is allocated the first
+ * time a list needs it, so the structure fits in 48 bytes and slots placed
+ * right after it (see init_small() and ARRAYLIST_SMALL) start within its
+ * first 64 bytes.
  */
 typedef struct ArrayList {
     void **arr;     /**< Pointer to the array of elements. */
     size_t n;       /**< Number of elements in the array. */
     size_t length;  /**< Total capacity of the array. */
+    unsigned flags; /**< Bitwise OR of `ARRAYLIST_*` flags given at initialization. */
+    ArrayListStorage storage;            /**< Where `arr` lives. */
+    const ArrayListAllocator *allocator; /**< Allocator owning `arr` and the structure itself. */
+    ArrayListExtension *extension;       /**< Rarely used state, or NULL while every part of it has its default. */
 } ArrayList;
 
+/**
+ * @brief Declares a small list whose structure and slots live together.
+ *
+ * `ARRAYLIST_SMALL(N)` is a structure type holding an ArrayList followed
+ * by `N` element slots and the terminator slot. Declared as a local
+ * variable and initialized with ARRAYLIST_SMALL_INIT(), it needs no
+ * allocation until it grows beyond `N` elements.
+ *
+ * @param N Number of elements stored inline.
+ */
+#define ARRAYLIST_SMALL(N) struct { ArrayList list; void *slots[(N) + 1]; }
+
+/**
+ * @brief Initializes an `ARRAYLIST_SMALL(N)` variable in place.
+ *
+ * Calls init_in_place() with the inline slots, so freeArrayList() must
+ * still be called on the result to release whatever the list allocated
+ * after initialization.
+ *
+ * @param small An `ARRAYLIST_SMALL(N)` lvalue.
+ * @return Pointer to the initialized ArrayList inside `small`.
+ */
+#define ARRAYLIST_SMALL_INIT(small) \
+    init_in_place(&(small).list, (small).slots, sizeof((small).slots) / sizeof((small).slots[0]))
+
+/**
+ * @brief Returns the default allocator.
+ *
+ * The default allocator forwards to `malloc`, `realloc` and `free`, and
+ * reports usable sizes with `malloc_usable_size` where glibc provides it.
+ *
+ * @return Pointer to the default allocator.
+ */
+const ArrayListAllocator* default_allocator(void);
+
 /**
  * @brief Initializes an ArrayList.
  *
@@ -36,10 +182,83 @@ typedef struct ArrayList {
  */
 ArrayList* init(const size_t length);
 
+/**
+ * @brief Initializes an ArrayList with a custom allocator.
+ *
+ * Both the ArrayList structure and its element buffer are obtained from
+ * `allocator`. The allocator must outlive the list.
+ *
+ * @param length Initial capacity of the ArrayList.
+ * @param allocator Allocator to use, or NULL for the default allocator.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_with_allocator(const size_t length, const ArrayListAllocator *allocator);
+
+/**
+ * @brief Initializes an ArrayList with a custom allocator and flags.
+ *
+ * @param length Initial capacity of the ArrayList.
+ * @param allocator Allocator to use, or NULL for the default allocator.
+ * @param flags Bitwise OR of `ARRAYLIST_*` flags.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_ex(const size_t length, const ArrayListAllocator *allocator, const unsigned flags);
+
+/**
+ * @brief Initializes a caller-owned ArrayList structure in place.
+ *
+ * Nothing is allocated when `buffer` is given: the list uses it until it
+ * outgrows it and then migrates to a heap buffer. freeArrayList() releases
+ * only what the list allocated itself, never `list` or `buffer`, and must
+ * still be called to release a buffer obtained after migrating.
+ *
+ * @param list Pointer to the caller-owned structure, e.g. a local variable.
+ * @param buffer Caller-owned initial buffer such as a stack array, or NULL
+ *               to allocate one from the default allocator.
+ * @param buffer_length Number of slots in `buffer`, one of which holds the
+ *                      nullptr terminator; with a NULL `buffer`, the
+ *                      initial capacity.
+ * @return `list`.
+ */
+ArrayList* init_in_place(ArrayList *list, void **buffer, const size_t buffer_length);
+
+/**
+ * @brief Initializes an ArrayList backed by a reserved virtual address range.
+ *
+ * Reserves enough address space for `max_length` elements up front and
+ * commits pages only as the list grows, so growing never copies and `arr`
+ * keeps the same address for the lifetime of the list. Growing beyond
+ * `max_length` is an error.
+ *
+ * @param length Initial capacity of the ArrayList.
+ * @param max_length Maximum capacity the ArrayList may ever reach.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_reserved(const size_t length, const size_t max_length);
+
+/**
+ * @brief Initializes an ArrayList whose first elements live inside the structure.
+ *
+ * The structure and `inline_length` element slots are obtained with a
+ * single allocation, so short lists cost one `malloc` instead of two and
+ * keep their elements right after the structure. The elements move to a
+ * separate heap buffer only once the list grows beyond `inline_length`.
+ *
+ * The first inline slot starts within 64 bytes of the structure, so a
+ * cache-line-aligned allocation keeps `n`, `length` and the first slots
+ * on one line. For lists that need no allocation at all, declare an
+ * ARRAYLIST_SMALL variable instead.
+ *
+ * @param inline_length Number of elements stored inline.
+ * @return Pointer to the initialized ArrayList.
+ */
+ArrayList* init_small(const size_t inline_length);
+
 /**
  * @brief Frees the memory used by an ArrayList.
  *
- * Frees both the dynamic array and the ArrayList structure itself.
+ * Frees both the dynamic array and the ArrayList structure itself, except
+ * for memory the list does not own (see init_in_place()).
  *
  * @param list Pointer to the ArrayList.
  */
@@ -53,6 +272,28 @@ void freeArrayList(ArrayList *list);
  */
 void push_back(ArrayList *list, const void *element);
 
+/**
+ * @brief Adds several elements to the end of the ArrayList.
+ *
+ * Grows at most once and copies all the pointers in one block.
+ * `elements` may point into the list itself, e.g. `&list->arr[i]`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param elements Array of `count` element pointers to add.
+ * @param count Number of elements to add.
+ */
+void push_back_many(ArrayList *list, const void **elements, const size_t count);
+
+/**
+ * @brief Adds all the elements of another ArrayList to the end of an ArrayList.
+ *
+ * `dst` and `src` may be the same list.
+ *
+ * @param dst Pointer to the ArrayList to extend.
+ * @param src Pointer to the ArrayList whose elements are added.
+ */
+void append_list(ArrayList *dst, const ArrayList *src);
+
 /**
  * @brief Removes the last element of the ArrayList.
  *
@@ -69,6 +310,30 @@ void pop_back(ArrayList *list);
  */
 void shrink_to_fit(ArrayList *list);
 
+/**
+ * @brief Sets the buffer size above which the ArrayList uses its own mapping.
+ *
+ * Once a resize needs at least `bytes` bytes, the element buffer is moved
+ * into a private anonymous mapping, and later resizes use `mremap` so the
+ * kernel remaps pages instead of copying them. Only effective on Linux;
+ * elsewhere the threshold is recorded but ignored.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param bytes Threshold in bytes, or 0 to disable.
+ */
+void set_mmap_threshold(ArrayList *list, const size_t bytes);
+
+/**
+ * @brief Sets the growth policy of the ArrayList.
+ *
+ * The default policy is geometric with a factor of 2, growing a full list
+ * of capacity `length` to `length * 2 + 1`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param policy Policy to copy into the list, or NULL to restore the default.
+ */
+void set_growth_policy(ArrayList *list, const ArrayListGrowthPolicy *policy);
+
 /**
  * @brief Returns the total capacity of the ArrayList.
  *
@@ -96,6 +361,16 @@ size_t get_number_of_elements(const ArrayList *list);
  */
 void resize(ArrayList *list, const size_t size);
 
+/**
+ * @brief Ensures the ArrayList can hold at least `size` elements.
+ *
+ * Unlike resize(), this never reduces the capacity.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param size Minimum capacity for the ArrayList.
+ */
+void reserve(ArrayList *list, const size_t size);
+
 /**
  * @brief Inserts an element at a specific index in the ArrayList.
  *
@@ -117,9 +392,90 @@ void insert_at(ArrayList *list, const void *element, const size_t index);
  */
 void remove_at(ArrayList *list, const size_t index);
 
+/**
+ * @brief Removes an element by moving the last element into its place.
+ *
+ * Runs in O(1) but does not preserve the order of the elements.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param index Index of the element to remove.
+ */
+void swap_remove_at(ArrayList *list, const size_t index);
+
+/**
+ * @brief Removes every element for which a predicate holds.
+ *
+ * Compacts the surviving elements in a single pass, preserving their order.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param pred Predicate returning true for elements to remove.
+ * @param ctx Context passed to `pred`.
+ * @return Number of elements removed.
+ */
+size_t erase_if(ArrayList *list, bool (*pred)(const void *element, void *ctx), void *ctx);
+
+/**
+ * @brief Removes the elements at a sorted set of indices.
+ *
+ * Moves each run of surviving elements once, so the whole removal is a
+ * single O(n) sweep regardless of how many indices are given.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param sorted_idx Indices to remove, in increasing order. Repeated
+ *                   indices are removed once.
+ * @param k Number of entries in `sorted_idx`.
+ */
+void remove_indices(ArrayList *list, const size_t *sorted_idx, const size_t k);
+
+/**
+ * @brief Inserts elements at a sorted set of positions.
+ *
+ * Each `sorted_idx[j]` is a position in the list as it was before the
+ * call: `elements[j]` ends up in front of the element that was at that
+ * position, or at the end for `n`. Elements sharing a position keep their
+ * order. The list grows at most once and the insertion is done in a single
+ * backward sweep that moves every existing element once.
+ * `elements` must not point into the list itself.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param sorted_idx Positions in non-decreasing order.
+ * @param elements Array of `k` element pointers to insert.
+ * @param k Number of elements to insert.
+ */
+void insert_indices(ArrayList *list, const size_t *sorted_idx, const void **elements, const size_t k);
+
+/**
+ * @brief Inserts several elements at a specific index in the ArrayList.
+ *
+ * Grows at most once and shifts the tail with a single `memmove`.
+ * `elements` must not point into the list itself.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param index Position at which to insert the first element.
+ * @param elements Array of `count` element pointers to insert.
+ * @param count Number of elements to insert.
+ */
+void insert_range(ArrayList *list, const size_t index, const void **elements, const size_t count);
+
+/**
+ * @brief Removes the elements in `[first, last)` from the ArrayList.
+ *
+ * Shifts the tail with a single `memmove`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param first Index of the first element to remove.
+ * @param last Index one past the last element to remove.
+ */
+void remove_range(ArrayList *list, const size_t first, const size_t last);
+
 /**
  * @brief Finds an element in the ArrayList using a comparator function.
  *
+ * When a Bloom filter was attached with `cmp`, most absent elements are
+ * rejected without scanning. When a hash index was attached with `cmp`,
+ * the lookup takes expected O(1) time; otherwise, when the list is known
+ * to be sorted by `cmp`, a binary search is used.
+ *
  * @param list Pointer to the ArrayList.
  * @param element Pointer to the element to find.
  * @param cmp Comparator function to compare elements.
@@ -127,4 +483,294 @@ void remove_at(ArrayList *list, const size_t index);
  */
 ssize_t find(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *));
 
+/**
+ * @brief Notifies the ArrayList that `arr` was modified directly.
+ *
+ * Must be called after writing to `arr` without going through the
+ * ArrayList functions, so that the sorted flag is dropped and the search
+ * index, hash index and Bloom filter are rebuilt.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void mark_modified(ArrayList *list);
+
+/**
+ * @brief Sorts the ArrayList.
+ *
+ * Uses a pattern-defeating quicksort working on the element slots
+ * directly: O(n log n) in the worst case, linear on sorted input, and
+ * without the adapter call per comparison of `qsort`. The order of equal
+ * elements is not preserved; see stable_sort().
+ *
+ * Afterwards the list is flagged as sorted by `cmp`: find() with the same
+ * comparator switches to binary search, and mutations keep or drop the
+ * flag as appropriate.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param cmp Comparator receiving two elements, as for find().
+ */
+void sort(ArrayList *list, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Sorts the ArrayList, keeping equal elements in their current order.
+ *
+ * Uses a natural merge sort: existing ascending or descending runs are
+ * reused, so nearly sorted lists take close to linear time. Needs a
+ * temporary buffer of `n / 2` slots from the list's allocator.
+ *
+ * Afterwards the list is flagged as sorted by `cmp`, as with sort().
+ *
+ * @param list Pointer to the ArrayList.
+ * @param cmp Comparator receiving two elements, as for find().
+ */
+void stable_sort(ArrayList *list, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Sorts the ArrayList by a 32-bit key with a radix sort.
+ *
+ * Runs in O(n) time with one `key` call per element, and keeps equal
+ * keys in their current order. Keys compare as unsigned integers: map
+ * signed keys by flipping the sign bit, and IEEE floats by flipping every
+ * bit of negative values and the sign bit of the others. Needs a
+ * temporary buffer of `n` slots and `2 * n` keys from the list's allocator.
+ *
+ * Having no comparator, the list is not flagged as sorted afterwards.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param key Function returning the sort key of an element.
+ */
+void sort_by_key_u32(ArrayList *list, uint32_t (*key)(const void *element));
+
+/**
+ * @brief Sorts the ArrayList by a 64-bit key with a radix sort.
+ *
+ * Runs in O(n) time with one `key` call per element, and keeps equal
+ * keys in their current order. Keys compare as unsigned integers: map
+ * signed keys by flipping the sign bit, and IEEE floats by flipping every
+ * bit of negative values and the sign bit of the others. Needs a
+ * temporary buffer of `n` slots and `2 * n` keys from the list's allocator.
+ *
+ * Having no comparator, the list is not flagged as sorted afterwards.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param key Function returning the sort key of an element.
+ */
+void sort_by_key_u64(ArrayList *list, uint64_t (*key)(const void *element));
+
+/**
+ * @brief Tells whether the ArrayList is sorted by a comparator.
+ *
+ * Answers from the sorted flag when it is set for `cmp`; otherwise checks
+ * the elements and sets the flag if they turn out to be sorted.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param cmp Comparator receiving two elements.
+ * @return true if the elements are in non-decreasing order under `cmp`.
+ */
+bool is_sorted(ArrayList *list, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Returns the index of the first element not less than `element`.
+ *
+ * The list must be sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param element Pointer to the element to compare against.
+ * @param cmp Comparator receiving two elements.
+ * @return Index in `[0, n]`.
+ */
+size_t lower_bound(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Returns the index of the first element greater than `element`.
+ *
+ * The list must be sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param element Pointer to the element to compare against.
+ * @param cmp Comparator receiving two elements.
+ * @return Index in `[0, n]`.
+ */
+size_t upper_bound(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Finds an element in a sorted ArrayList with binary search.
+ *
+ * The list must be sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param element Pointer to the element to find.
+ * @param cmp Comparator receiving two elements.
+ * @return Index of the first equal element if found, -1 otherwise.
+ */
+ssize_t binary_find(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Inserts an element at its ordered position in a sorted ArrayList.
+ *
+ * The element goes after any equal elements, and the list stays flagged
+ * as sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList, sorted by `cmp`.
+ * @param element Pointer to the element to insert.
+ * @param cmp Comparator receiving two elements.
+ * @return Index at which the element was inserted.
+ */
+size_t insert_sorted(ArrayList *list, const void *element, int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Finds the first element that is the given pointer.
+ *
+ * Compares pointer identity only, without calling a comparator. On x86-64
+ * the scan uses the widest SIMD instruction set the CPU supports.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param ptr Pointer to look for.
+ * @return Index of the first occurrence if found, -1 otherwise.
+ */
+ssize_t find_ptr(const ArrayList *list, const void *ptr);
+
+/**
+ * @brief Finds the last element that is the given pointer.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param ptr Pointer to look for.
+ * @return Index of the last occurrence if found, -1 otherwise.
+ */
+ssize_t find_ptr_last(const ArrayList *list, const void *ptr);
+
+/**
+ * @brief Counts the elements that are the given pointer.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param ptr Pointer to look for.
+ * @return Number of occurrences of `ptr`.
+ */
+size_t count_ptr(const ArrayList *list, const void *ptr);
+
+/**
+ * @brief Finds an element by a fixed-width key stored inside it.
+ *
+ * Compares `key_width` bytes at `key_offset` within each element against
+ * `key`, with no comparator call per element. Widths of 1, 2, 4 and 8
+ * bytes compare as integers; any other width is compared with `memcmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param key_offset Offset in bytes of the key inside each element, e.g.
+ *                   from `offsetof`.
+ * @param key_width Size in bytes of the key.
+ * @param key Pointer to the `key_width` bytes to look for.
+ * @return Index of the first element whose key matches, -1 otherwise.
+ */
+ssize_t find_by_key(const ArrayList *list, const size_t key_offset, const size_t key_width, const void *key);
+
+/**
+ * @brief Builds a cache-friendly search index over the keys of a sorted ArrayList.
+ *
+ * Extracts the key of every element once and stores the keys in
+ * Eytzinger (BFS) order next to the list, so that search_index_find()
+ * runs a branchless, prefetching search instead of a binary search that
+ * misses cache at every level. The list must be sorted by key. Any
+ * mutation marks the index stale, and the next search rebuilds it.
+ *
+ * @param list Pointer to the ArrayList, sorted by `key_fn`.
+ * @param key_fn Function returning the key of an element.
+ */
+void build_search_index(ArrayList *list, uint64_t (*key_fn)(const void *element));
+
+/**
+ * @brief Finds an element by key using the search index.
+ *
+ * Rebuilds the index first if the list changed since it was built.
+ *
+ * @param list Pointer to the ArrayList with a search index.
+ * @param key Key to look for.
+ * @return Index of the first element with that key if found, -1 otherwise.
+ */
+ssize_t search_index_find(ArrayList *list, const uint64_t key);
+
+/**
+ * @brief Releases the search index of an ArrayList, if any.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void free_search_index(ArrayList *list);
+
+/**
+ * @brief Attaches a hash index to the ArrayList.
+ *
+ * Afterwards find() called with `cmp` looks elements up in expected O(1)
+ * time instead of scanning, still returning the first matching index.
+ * Elements that compare equal under `cmp` must have equal hashes.
+ * Replaces any hash index already attached.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param hash Hash function receiving an element.
+ * @param cmp Comparator receiving two elements, returning 0 when equal.
+ */
+void attach_hash_index(ArrayList *list, uint64_t (*hash)(const void *element),
+                       int (*cmp)(const void *, const void *));
+
+/**
+ * @brief Releases the hash index of an ArrayList, if any.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void free_hash_index(ArrayList *list);
+
+/**
+ * @brief Attaches a blocked Bloom filter to the ArrayList.
+ *
+ * Afterwards find() called with `cmp` first asks the filter and returns -1
+ * immediately for most absent elements. push_back, insert_at and the bulk
+ * insertions add to the filter; removals leave it untouched, so after
+ * heavy removal churn call rebuild_bloom_filter(). Elements that compare
+ * equal under `cmp` must have equal hashes. Replaces any filter already
+ * attached.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param hash Hash function receiving an element.
+ * @param cmp Comparator the filter accelerates, as passed to find().
+ * @param bits_per_element Filter bits per element; 8 to 16 gives roughly a
+ *                         1% to 0.1% false-positive rate.
+ */
+void attach_bloom_filter(ArrayList *list, uint64_t (*hash)(const void *element),
+                         int (*cmp)(const void *, const void *), const size_t bits_per_element);
+
+/**
+ * @brief Recomputes the Bloom filter from the current elements.
+ *
+ * Clears the bits left behind by removed elements and resizes the filter
+ * for the current number of elements.
+ *
+ * @param list Pointer to the ArrayList with a Bloom filter.
+ */
+void rebuild_bloom_filter(ArrayList *list);
+
+/**
+ * @brief Returns the lookup counters of the Bloom filter.
+ *
+ * The false-positive rate is `false_positives / (rejections + false_positives)`
+ * over lookups of absent elements. While other threads call find(), the
+ * counters are read one at a time and may be slightly out of step.
+ *
+ * @param list Pointer to the ArrayList with a Bloom filter.
+ * @return Counters accumulated since the filter was attached or last reset.
+ */
+ArrayListBloomStats get_bloom_filter_stats(const ArrayList *list);
+
+/**
+ * @brief Resets the lookup counters of the Bloom filter.
+ *
+ * @param list Pointer to the ArrayList with a Bloom filter.
+ */
+void reset_bloom_filter_stats(ArrayList *list);
+
+/**
+ * @brief Releases the Bloom filter of an ArrayList, if any.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void free_bloom_filter(ArrayList *list);
+
 #endif // ARRAYLIST_H
\ No newline at end of file
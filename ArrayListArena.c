@@ -0,0 +1,166 @@
+/**
+ * @file ArrayListArena.c
+ * @brief Implementation of the ArrayList arena allocator.
+ */
+
+#include "ArrayListArena.h"
+#include "ArrayListInternal.h"
+#include <stdalign.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT alignof(max_align_t)
+
+/**
+ * @struct ArenaBlock
+ * @brief A contiguous chunk of memory from which allocations are bumped.
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;  /**< Next block in the chain. */
+    size_t capacity;          /**< Usable bytes in `data`. */
+    size_t used;              /**< Bytes already handed out. */
+    alignas(max_align_t) unsigned char data[]; /**< Block storage. */
+} ArenaBlock;
+
+struct ArrayListArena {
+    ArrayListAllocator allocator; /**< Allocator vtable with `ctx` pointing to the arena. */
+    ArenaBlock *first;            /**< First block of the chain. */
+    ArenaBlock *current;          /**< Block allocations are currently bumped from. */
+    void *last;                   /**< Most recent allocation, which may grow in place. */
+    size_t block_size;            /**< Default capacity of new blocks. */
+};
+
+static size_t align_up(const size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+static ArenaBlock *new_block(const size_t capacity) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + capacity);
+    if (block == NULL) THROW_ERROR("out of memory");
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+static void *arena_allocate(void *ctx, size_t size) {
+    ArrayListArena *arena = ctx;
+    size = align_up(size);
+    ArenaBlock *block = arena->current;
+    while (block->capacity - block->used < size) {
+        if (block->next == NULL || block->next->capacity < size) {
+            // Splice a fresh block in after the current one; retained blocks that
+            // are too small stay in the chain for later, smaller requests.
+            ArenaBlock *fresh = new_block(size > arena->block_size ? size : arena->block_size);
+            fresh->next = block->next;
+            block->next = fresh;
+        }
+        block = block->next;
+    }
+    arena->current = block;
+    void *ptr = block->data + block->used;
+    block->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+static void *arena_reallocate(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    ArrayListArena *arena = ctx;
+    if (ptr == NULL) return arena_allocate(ctx, new_size);
+    if (ptr == arena->last) {
+        ArenaBlock *block = arena->current;
+        const size_t offset = (size_t)((unsigned char *)ptr - block->data);
+        if (block->capacity - offset >= align_up(new_size)) {
+            block->used = offset + align_up(new_size);
+            return ptr;
+        }
+    }
+    void *newPtr = arena_allocate(ctx, new_size);
+    memcpy(newPtr, ptr, old_size < new_size ? old_size : new_size);
+    return newPtr;
+}
+
+static void arena_deallocate(void *ctx, void *ptr, size_t size) {
+    ArrayListArena *arena = ctx;
+    (void)size;
+    if (ptr != NULL && ptr == arena->last) {
+        // Only the most recent allocation can be returned to the block.
+        arena->current->used = (size_t)((unsigned char *)ptr - arena->current->data);
+        arena->last = NULL;
+    }
+}
+
+static size_t arena_usable_size(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    (void)ptr;
+    return align_up(size);
+}
+
+/**
+ * @brief Creates an arena.
+ *
+ * @param block_size Size in bytes of each block requested from `malloc`.
+ *                   Larger allocations get a dedicated block.
+ * @return Pointer to the new arena.
+ */
+ArrayListArena* arena_create(const size_t block_size) {
+    ArrayListArena *arena = malloc(sizeof(ArrayListArena));
+    if (arena == NULL) THROW_ERROR("out of memory");
+    arena->block_size = align_up(block_size > 0 ? block_size : 1);
+    arena->first = new_block(arena->block_size);
+    arena->current = arena->first;
+    arena->last = NULL;
+    arena->allocator = (ArrayListAllocator){
+        .allocate = arena_allocate,
+        .reallocate = arena_reallocate,
+        .deallocate = arena_deallocate,
+        .ctx = arena,
+        .usable_size = arena_usable_size,
+    };
+    return arena;
+}
+
+/**
+ * @brief Destroys an arena and releases all of its blocks.
+ *
+ * Every list allocated from the arena becomes invalid.
+ *
+ * @param arena Pointer to the arena.
+ */
+void arena_destroy(ArrayListArena *arena) {
+    ArenaBlock *block = arena->first;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+/**
+ * @brief Releases every allocation made from the arena.
+ *
+ * The blocks are kept and reused by later allocations. Every list
+ * allocated from the arena becomes invalid.
+ *
+ * @param arena Pointer to the arena.
+ */
+void arena_reset(ArrayListArena *arena) {
+    for (ArenaBlock *block = arena->first; block != NULL; block = block->next) {
+        block->used = 0;
+    }
+    arena->current = arena->first;
+    arena->last = NULL;
+}
+
+/**
+ * @brief Returns the allocator backed by an arena.
+ *
+ * Pass the result to init_with_allocator(). Growing the most recently
+ * allocated buffer extends it in place when the current block has room.
+ *
+ * @param arena Pointer to the arena.
+ * @return Pointer to the allocator, valid for the lifetime of the arena.
+ */
+const ArrayListAllocator* arena_allocator(ArrayListArena *arena) {
+    return &arena->allocator;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file ArrayListArena.h
+ * @brief A bump allocator for short-lived ArrayLists.
+ *
+ * An arena hands out memory from large blocks and releases everything at
+ * once. Lists created with the arena's allocator do not need to be freed
+ * individually: a single call to arena_reset() releases all of them.
+ */
+
+#ifndef ARRAYLIST_ARENA_H
+#define ARRAYLIST_ARENA_H
+
+#include "ArrayList.h"
+
+/**
+ * @struct ArrayListArena
+ * @brief Opaque bump allocator.
+ */
+typedef struct ArrayListArena ArrayListArena;
+
+/**
+ * @brief Creates an arena.
+ *
+ * @param block_size Size in bytes of each block requested from `malloc`.
+ *                   Larger allocations get a dedicated block.
+ * @return Pointer to the new arena.
+ */
+ArrayListArena* arena_create(const size_t block_size);
+
+/**
+ * @brief Destroys an arena and releases all of its blocks.
+ *
+ * Every list allocated from the arena becomes invalid.
+ *
+ * @param arena Pointer to the arena.
+ */
+void arena_destroy(ArrayListArena *arena);
+
+/**
+ * @brief Releases every allocation made from the arena.
+ *
+ * The blocks are kept and reused by later allocations. Every list
+ * allocated from the arena becomes invalid.
+ *
+ * @param arena Pointer to the arena.
+ */
+void arena_reset(ArrayListArena *arena);
+
+/**
+ * @brief Returns the allocator backed by an arena.
+ *
+ * Pass the result to init_with_allocator(). Growing the most recently
+ * allocated buffer extends it in place when the current block has room.
+ *
+ * @param arena Pointer to the arena.
+ * @return Pointer to the allocator, valid for the lifetime of the arena.
+ */
+const ArrayListAllocator* arena_allocator(ArrayListArena *arena);
+
+#endif // ARRAYLIST_ARENA_H
@@ -0,0 +1,225 @@
+/**
+ * @file ArrayListBloom.c
+ * @brief Blocked Bloom filter answering "definitely absent" for find().
+ *
+ * Every element sets a few bits inside a single 512-bit block chosen by
+ * its hash, so a query touches exactly one cache line. Removing elements
+ * never clears bits: the filter only grows more permissive until
+ * rebuild_bloom_filter() recomputes it from the current elements.
+ *
+ * Lookups only read the bits and bump the counters with relaxed atomic
+ * increments, so concurrent find() calls on a list nobody mutates are safe.
+ */
+
+#include "ArrayList.h"
+#include "ArrayListInternal.h"
+#include <string.h>
+
+#define BLOCK_BITS 512
+#define BLOCK_WORDS (BLOCK_BITS / 64)
+#define BLOCK_ALIGNMENT 64
+#define MAX_PROBES 7 // 7 probes of 9 bits each fit in one 64-bit mix
+#define MIN_BLOOM_CAPACITY 64
+
+/**
+ * @brief Mixes a user hash so that weak hashes still spread over blocks and bits.
+ */
+static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/**
+ * @brief Returns the block selected by the high half of a mixed hash.
+ */
+static uint64_t *block_of(const ArrayListBloomFilter *filter, const uint64_t mixed) {
+    const size_t block = (size_t)((mixed >> 32) * filter->block_count >> 32);
+    return filter->blocks + block * BLOCK_WORDS;
+}
+
+/**
+ * @brief Returns 9-bit probe positions packed into 63 bits, decorrelated from the block choice.
+ */
+static uint64_t probes_of(const uint64_t mixed) {
+    return mixed * 0x9e3779b97f4a7c15ULL;
+}
+
+static void add_hash(ArrayListBloomFilter *filter, const uint64_t hash) {
+    const uint64_t mixed = mix(hash);
+    uint64_t *block = block_of(filter, mixed);
+    const uint64_t probes = probes_of(mixed);
+    for (unsigned i = 0; i < filter->probes; i++) {
+        const unsigned bit = (unsigned)(probes >> (9 * i)) & (BLOCK_BITS - 1);
+        block[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+static bool may_contain(const ArrayListBloomFilter *filter, const uint64_t hash) {
+    const uint64_t mixed = mix(hash);
+    const uint64_t *block = block_of(filter, mixed);
+    const uint64_t probes = probes_of(mixed);
+    bool present = true;
+    for (unsigned i = 0; i < filter->probes; i++) {
+        const unsigned bit = (unsigned)(probes >> (9 * i)) & (BLOCK_BITS - 1);
+        present &= (block[bit / 64] >> (bit % 64)) & 1;
+    }
+    return present;
+}
+
+/**
+ * @brief Sizes the filter for `capacity` elements and fills it from the list.
+ */
+static void rebuild(const ArrayList *list, ArrayListBloomFilter *filter, size_t capacity) {
+    if (capacity < MIN_BLOOM_CAPACITY) capacity = MIN_BLOOM_CAPACITY;
+    const size_t block_count = (capacity * filter->bits_per_element + BLOCK_BITS - 1) / BLOCK_BITS;
+    const size_t bytes = BLOCK_ALIGNMENT + block_count * BLOCK_WORDS * sizeof(uint64_t);
+    const ArrayListAllocator *allocator = list->allocator;
+    if (bytes > filter->storage_bytes) {
+        if (filter->storage != NULL) allocator->deallocate(allocator->ctx, filter->storage, filter->storage_bytes);
+        filter->storage = allocator->allocate(allocator->ctx, bytes);
+        if (filter->storage == NULL) THROW_ERROR("out of memory");
+        filter->storage_bytes = bytes;
+    }
+    const uintptr_t aligned = ((uintptr_t)filter->storage + BLOCK_ALIGNMENT - 1) & ~(uintptr_t)(BLOCK_ALIGNMENT - 1);
+    filter->blocks = (uint64_t *)aligned;
+    filter->block_count = block_count;
+    filter->capacity = capacity;
+    memset(filter->blocks, 0, block_count * BLOCK_WORDS * sizeof(uint64_t));
+    for (size_t i = 0; i < list->n; i++) {
+        add_hash(filter, filter->hash(list->arr[i]));
+    }
+    filter->inserted = list->n;
+}
+
+void arraylist_bloom_add(ArrayList *list, const void *const *elements, const size_t count) {
+    ArrayListBloomFilter *filter = arraylist_extension(list)->bloom_filter;
+    if (filter == NULL) return;
+    if (filter->inserted + count > filter->capacity) {
+        // Past its planned load the false-positive rate climbs quickly; resize ahead of growth.
+        // The new elements are already in the list, so the rebuild covers them.
+        rebuild(list, filter, 2 * list->n);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        add_hash(filter, filter->hash(elements[i]));
+    }
+    filter->inserted += count;
+}
+
+bool arraylist_bloom_rejects(const ArrayList *list, const void *element) {
+    ArrayListBloomFilter *filter = arraylist_extension(list)->bloom_filter;
+    __atomic_fetch_add(&filter->stats.lookups, 1, __ATOMIC_RELAXED);
+    if (!may_contain(filter, filter->hash(element))) {
+        __atomic_fetch_add(&filter->stats.rejections, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+    return false;
+}
+
+void arraylist_bloom_missed(const ArrayList *list) {
+    __atomic_fetch_add(&arraylist_extension(list)->bloom_filter->stats.false_positives, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Attaches a blocked Bloom filter to the ArrayList.
+ *
+ * Afterwards find() called with `cmp` first asks the filter and returns -1
+ * immediately for most absent elements. push_back, insert_at and the bulk
+ * insertions add to the filter; removals leave it untouched, so after
+ * heavy removal churn call rebuild_bloom_filter(). Elements that compare
+ * equal under `cmp` must have equal hashes. Replaces any filter already
+ * attached.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param hash Hash function receiving an element.
+ * @param cmp Comparator the filter accelerates, as passed to find().
+ * @param bits_per_element Filter bits per element; 8 to 16 gives roughly a
+ *                         1% to 0.1% false-positive rate.
+ */
+void attach_bloom_filter(ArrayList *list, uint64_t (*hash)(const void *element),
+                         int (*cmp)(const void *, const void *), const size_t bits_per_element) {
+    if (bits_per_element == 0) THROW_ERROR("bits per element must be positive");
+    free_bloom_filter(list);
+    const ArrayListAllocator *allocator = list->allocator;
+    ArrayListBloomFilter *filter = allocator->allocate(allocator->ctx, sizeof(ArrayListBloomFilter));
+    if (filter == NULL) THROW_ERROR("out of memory");
+    filter->hash = hash;
+    filter->cmp = cmp;
+    filter->bits_per_element = bits_per_element;
+    // The optimal number of probes is ln 2 * bits per element.
+    filter->probes = (unsigned)((double)bits_per_element * 0.693 + 0.5);
+    if (filter->probes < 1) filter->probes = 1;
+    if (filter->probes > MAX_PROBES) filter->probes = MAX_PROBES;
+    filter->storage = NULL;
+    filter->storage_bytes = 0;
+    filter->stats = (ArrayListBloomStats){0};
+    arraylist_ensure_extension(list)->bloom_filter = filter;
+    rebuild(list, filter, 2 * list->n);
+}
+
+/**
+ * @brief Recomputes the Bloom filter from the current elements.
+ *
+ * Clears the bits left behind by removed elements and resizes the filter
+ * for the current number of elements.
+ *
+ * @param list Pointer to the ArrayList with a Bloom filter.
+ */
+void rebuild_bloom_filter(ArrayList *list) {
+    ArrayListBloomFilter *filter = arraylist_extension(list)->bloom_filter;
+    if (filter == NULL) THROW_ERROR("no Bloom filter");
+    rebuild(list, filter, 2 * list->n);
+}
+
+/**
+ * @brief Returns the lookup counters of the Bloom filter.
+ *
+ * The false-positive rate is `false_positives / (rejections + false_positives)`
+ * over lookups of absent elements. While other threads call find(), the
+ * counters are read one at a time and may be slightly out of step.
+ *
+ * @param list Pointer to the ArrayList with a Bloom filter.
+ * @return Counters accumulated since the filter was attached or last reset.
+ */
+ArrayListBloomStats get_bloom_filter_stats(const ArrayList *list) {
+    const ArrayListBloomFilter *filter = arraylist_extension(list)->bloom_filter;
+    if (filter == NULL) THROW_ERROR("no Bloom filter");
+    const ArrayListBloomStats *stats = &filter->stats;
+    return (ArrayListBloomStats){
+        .lookups = __atomic_load_n(&stats->lookups, __ATOMIC_RELAXED),
+        .rejections = __atomic_load_n(&stats->rejections, __ATOMIC_RELAXED),
+        .false_positives = __atomic_load_n(&stats->false_positives, __ATOMIC_RELAXED),
+    };
+}
+
+/**
+ * @brief Resets the lookup counters of the Bloom filter.
+ *
+ * @param list Pointer to the ArrayList with a Bloom filter.
+ */
+void reset_bloom_filter_stats(ArrayList *list) {
+    ArrayListBloomFilter *filter = arraylist_extension(list)->bloom_filter;
+    if (filter == NULL) THROW_ERROR("no Bloom filter");
+    ArrayListBloomStats *stats = &filter->stats;
+    __atomic_store_n(&stats->lookups, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->rejections, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->false_positives, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Releases the Bloom filter of an ArrayList, if any.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void free_bloom_filter(ArrayList *list) {
+    ArrayListBloomFilter *filter = arraylist_extension(list)->bloom_filter;
+    if (filter == NULL) return;
+    const ArrayListAllocator *allocator = list->allocator;
+    if (filter->storage != NULL) allocator->deallocate(allocator->ctx, filter->storage, filter->storage_bytes);
+    allocator->deallocate(allocator->ctx, filter, sizeof(ArrayListBloomFilter));
+    list->extension->bloom_filter = NULL;
+}
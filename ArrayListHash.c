@@ -0,0 +1,273 @@
+/**
+ * @file ArrayListHash.c
+ * @brief Open-addressing hash index mapping elements to their positions.
+ *
+ * The table uses linear probing and stores, for every element, its hash
+ * and its index in the list. Deletions shift the following entries back
+ * instead of leaving tombstones, so probe sequences stay short under
+ * churn. Single-element mutations and bulk insertions update the table
+ * incrementally; bulk removals and reorderings rebuild it when they
+ * finish. Lookups never write to the table, so concurrent find() calls on
+ * a list nobody mutates are safe.
+ */
+
+#include "ArrayList.h"
+#include "ArrayListInternal.h"
+
+#define EMPTY_SLOT SIZE_MAX
+#define MIN_HASH_CAPACITY 16
+
+/**
+ * @brief Allocates an empty table of `capacity` slots, a power of two.
+ */
+static void allocate_table(const ArrayList *list, ArrayListHashIndex *index, const size_t capacity) {
+    const ArrayListAllocator *allocator = list->allocator;
+    index->entries = allocator->allocate(allocator->ctx, capacity * sizeof(ArrayListHashEntry));
+    if (index->entries == NULL) THROW_ERROR("out of memory");
+    index->capacity = capacity;
+    for (size_t i = 0; i < capacity; i++) {
+        index->entries[i].position = EMPTY_SLOT;
+    }
+}
+
+static void place(ArrayListHashIndex *index, const uint64_t hash, const size_t position) {
+    const size_t mask = index->capacity - 1;
+    size_t i = (size_t)hash & mask;
+    while (index->entries[i].position != EMPTY_SLOT) {
+        i = (i + 1) & mask;
+    }
+    index->entries[i].hash = hash;
+    index->entries[i].position = position;
+}
+
+/**
+ * @brief Moves every entry into a table of `capacity` slots without rehashing elements.
+ */
+static void resize_table(const ArrayList *list, ArrayListHashIndex *index, const size_t capacity) {
+    const ArrayListAllocator *allocator = list->allocator;
+    ArrayListHashEntry *old = index->entries;
+    const size_t oldCapacity = index->capacity;
+    allocate_table(list, index, capacity);
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (old[i].position != EMPTY_SLOT) place(index, old[i].hash, old[i].position);
+    }
+    if (old != NULL) allocator->deallocate(allocator->ctx, old, oldCapacity * sizeof(ArrayListHashEntry));
+}
+
+/**
+ * @brief Grows the table, at most once, so that `extra` more entries keep it at most 3/4 full.
+ */
+static void reserve_entries(const ArrayList *list, ArrayListHashIndex *index, const size_t extra) {
+    size_t capacity = index->capacity;
+    while ((index->count + extra) * 4 > capacity * 3) capacity *= 2;
+    if (capacity != index->capacity) resize_table(list, index, capacity);
+}
+
+/**
+ * @brief Returns the smallest power-of-two capacity keeping `count` entries at most half full.
+ */
+static size_t capacity_for(const size_t count) {
+    size_t capacity = MIN_HASH_CAPACITY;
+    while (capacity < count * 2) capacity *= 2;
+    return capacity;
+}
+
+static void rebuild(const ArrayList *list, ArrayListHashIndex *index) {
+    const size_t capacity = capacity_for(list->n);
+    if (capacity != index->capacity) {
+        const ArrayListAllocator *allocator = list->allocator;
+        if (index->entries != NULL) {
+            allocator->deallocate(allocator->ctx, index->entries, index->capacity * sizeof(ArrayListHashEntry));
+        }
+        allocate_table(list, index, capacity);
+    } else {
+        for (size_t i = 0; i < capacity; i++) {
+            index->entries[i].position = EMPTY_SLOT;
+        }
+    }
+    for (size_t i = 0; i < list->n; i++) {
+        place(index, index->hash(list->arr[i]), i);
+    }
+    index->count = list->n;
+}
+
+/**
+ * @brief Returns the slot holding the entry of the element at `position`.
+ */
+static size_t locate(const ArrayList *list, const ArrayListHashIndex *index, const size_t position) {
+    const size_t mask = index->capacity - 1;
+    size_t i = (size_t)index->hash(list->arr[position]) & mask;
+    while (index->entries[i].position != position) {
+        if (index->entries[i].position == EMPTY_SLOT) THROW_ERROR("hash index out of sync");
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * @brief Empties slot `i`, shifting later entries of the probe run back into the hole.
+ */
+static void delete_slot(ArrayListHashIndex *index, size_t i) {
+    const size_t mask = index->capacity - 1;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (index->entries[j].position == EMPTY_SLOT) break;
+        const size_t home = (size_t)index->entries[j].hash & mask;
+        // The entry may fill the hole unless its home lies cyclically in (i, j].
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            index->entries[i] = index->entries[j];
+            i = j;
+        }
+    }
+    index->entries[i].position = EMPTY_SLOT;
+    index->count--;
+}
+
+/**
+ * @brief Adds `delta` to the position of every entry at or after `from`.
+ */
+static void shift_positions(ArrayListHashIndex *index, const size_t from, const ptrdiff_t delta) {
+    for (size_t i = 0; i < index->capacity; i++) {
+        const size_t position = index->entries[i].position;
+        if (position != EMPTY_SLOT && position >= from) {
+            index->entries[i].position = (size_t)((ptrdiff_t)position + delta);
+        }
+    }
+}
+
+void arraylist_hash_rebuild(ArrayList *list) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index != NULL) rebuild(list, index);
+}
+
+void arraylist_hash_inserted(ArrayList *list, const size_t position) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index == NULL) return;
+    if (position + 1 != list->n) shift_positions(index, position, 1);
+    reserve_entries(list, index, 1);
+    place(index, index->hash(list->arr[position]), position);
+    index->count++;
+}
+
+void arraylist_hash_inserted_range(ArrayList *list, const size_t position, const size_t count) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index == NULL) return;
+    if (position + count != list->n) shift_positions(index, position, (ptrdiff_t)count);
+    reserve_entries(list, index, count);
+    for (size_t i = position; i < position + count; i++) {
+        place(index, index->hash(list->arr[i]), i);
+    }
+    index->count += count;
+}
+
+/**
+ * @brief Returns how many of the `k` sorted positions are at most `position`.
+ */
+static size_t count_at_or_before(const size_t *sorted_idx, const size_t k, const size_t position) {
+    size_t first = 0;
+    size_t count = k;
+    while (count > 0) {
+        const size_t half = count / 2;
+        if (sorted_idx[first + half] <= position) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+void arraylist_hash_inserted_indices(ArrayList *list, const size_t *sorted_idx, const size_t k) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index == NULL) return;
+    if (sorted_idx[0] < list->n - k) {
+        // An old element moves past every new element inserted at or before its position.
+        for (size_t i = 0; i < index->capacity; i++) {
+            const size_t position = index->entries[i].position;
+            if (position != EMPTY_SLOT) {
+                index->entries[i].position = position + count_at_or_before(sorted_idx, k, position);
+            }
+        }
+    }
+    reserve_entries(list, index, k);
+    for (size_t j = 0; j < k; j++) {
+        const size_t position = sorted_idx[j] + j;
+        place(index, index->hash(list->arr[position]), position);
+    }
+    index->count += k;
+}
+
+void arraylist_hash_removing(ArrayList *list, const size_t position) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index == NULL) return;
+    delete_slot(index, locate(list, index, position));
+    if (position + 1 != list->n) shift_positions(index, position + 1, -1);
+}
+
+void arraylist_hash_swap_removing(ArrayList *list, const size_t position) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index == NULL) return;
+    delete_slot(index, locate(list, index, position));
+    const size_t last = list->n - 1;
+    if (position != last) index->entries[locate(list, index, last)].position = position;
+}
+
+ssize_t arraylist_hash_find(const ArrayList *list, const void *element) {
+    const ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    const uint64_t hash = index->hash(element);
+    const size_t mask = index->capacity - 1;
+    size_t best = EMPTY_SLOT;
+    // Equal elements share a hash and thus a probe run; keep the first position to match find().
+    for (size_t i = (size_t)hash & mask; index->entries[i].position != EMPTY_SLOT; i = (i + 1) & mask) {
+        const ArrayListHashEntry *entry = &index->entries[i];
+        if (entry->hash == hash && entry->position < best && index->cmp(list->arr[entry->position], element) == 0) {
+            best = entry->position;
+        }
+    }
+    return best == EMPTY_SLOT ? -1 : (ssize_t)best;
+}
+
+/**
+ * @brief Attaches a hash index to the ArrayList.
+ *
+ * Afterwards find() called with `cmp` looks elements up in expected O(1)
+ * time instead of scanning, still returning the first matching index.
+ * Elements that compare equal under `cmp` must have equal hashes.
+ * Replaces any hash index already attached.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param hash Hash function receiving an element.
+ * @param cmp Comparator receiving two elements, returning 0 when equal.
+ */
+void attach_hash_index(ArrayList *list, uint64_t (*hash)(const void *element),
+                       int (*cmp)(const void *, const void *)) {
+    free_hash_index(list);
+    const ArrayListAllocator *allocator = list->allocator;
+    ArrayListHashIndex *index = allocator->allocate(allocator->ctx, sizeof(ArrayListHashIndex));
+    if (index == NULL) THROW_ERROR("out of memory");
+    index->hash = hash;
+    index->cmp = cmp;
+    index->entries = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    arraylist_ensure_extension(list)->hash_index = index;
+    rebuild(list, index);
+}
+
+/**
+ * @brief Releases the hash index of an ArrayList, if any.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void free_hash_index(ArrayList *list) {
+    ArrayListHashIndex *index = arraylist_extension(list)->hash_index;
+    if (index == NULL) return;
+    const ArrayListAllocator *allocator = list->allocator;
+    if (index->entries != NULL) {
+        allocator->deallocate(allocator->ctx, index->entries, index->capacity * sizeof(ArrayListHashEntry));
+    }
+    allocator->deallocate(allocator->ctx, index, sizeof(ArrayListHashIndex));
+    list->extension->hash_index = NULL;
+}
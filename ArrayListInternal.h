@@ -0,0 +1,200 @@
+/**
+ * @file ArrayListInternal.h
+ * @brief Helpers shared by the ArrayList translation units.
+ *
+ * This header is not part of the public API.
+ */
+
+#ifndef ARRAYLIST_INTERNAL_H
+#define ARRAYLIST_INTERNAL_H
+
+#include "ArrayList.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Macro for throwing an error and terminating the program.
+ *
+ * This macro prints an error message to `stderr` with the function name
+ * where the error occurred, and then exits the program with a failure code.
+ *
+ * @param msg A string describing the error.
+ *
+ * @note This macro uses `fprintf` and `exit`, so it immediately terminates
+ *       the program. Use with caution in critical or multi-threaded contexts.
+ */
+#define THROW_ERROR(msg) fprintf(stderr, "[ERROR] %s in function: %s\n", msg, __func__), exit(EXIT_FAILURE)
+
+/**
+ * @struct ArrayListSearchIndex
+ * @brief Keys of a sorted ArrayList laid out in Eytzinger (BFS) order.
+ *
+ * Slot 1 holds the median key, and the children of slot `k` are `2k` and
+ * `2k + 1`, so the first levels of every search share a few cache lines.
+ */
+struct ArrayListSearchIndex {
+    uint64_t (*key_fn)(const void *element); /**< Extracts the key of an element. */
+    uint64_t *keys;      /**< Keys in Eytzinger order, 1-based; `keys` is cache-line aligned. */
+    size_t *positions;   /**< `positions[k]` is the list index of the element behind `keys[k]`. */
+    void *block;         /**< Allocation holding `keys` and `positions`. */
+    size_t block_bytes;  /**< Size of `block` in bytes. */
+    size_t n;            /**< Number of keys. */
+    bool stale;          /**< Set when the list changed since the index was built. */
+};
+
+/**
+ * @struct ArrayListHashEntry
+ * @brief Slot of the hash index.
+ */
+typedef struct ArrayListHashEntry {
+    uint64_t hash;   /**< Hash of the element. */
+    size_t position; /**< Index of the element in the list, or SIZE_MAX for an empty slot. */
+} ArrayListHashEntry;
+
+/**
+ * @struct ArrayListHashIndex
+ * @brief Linear-probing table from elements to their positions in the list.
+ */
+struct ArrayListHashIndex {
+    uint64_t (*hash)(const void *element);          /**< Hash function of the elements. */
+    int (*cmp)(const void *, const void *);         /**< Equality, as a comparator returning 0. */
+    ArrayListHashEntry *entries;                    /**< Table of `capacity` slots. */
+    size_t capacity;                                /**< Number of slots, a power of two. */
+    size_t count;                                   /**< Number of occupied slots. */
+};
+
+/**
+ * @brief Records that the elements were permuted in place.
+ *
+ * Drops the sorted flag, marks the search index stale and rebuilds the
+ * hash index. The Bloom filter is kept, since the set of elements did
+ * not change.
+ */
+void arraylist_reordered(ArrayList *list);
+
+/**
+ * @brief Recomputes the hash index, if the list has one, after a bulk removal or reordering.
+ *
+ * Called once the mutation is complete, so that find() never has to
+ * write to the table.
+ */
+void arraylist_hash_rebuild(ArrayList *list);
+
+/**
+ * @brief Records in the hash index that an element was inserted at `position`.
+ *
+ * Called after `arr` and `n` were updated.
+ */
+void arraylist_hash_inserted(ArrayList *list, size_t position);
+
+/**
+ * @brief Records in the hash index that `count` elements were inserted at `position`.
+ *
+ * Called after `arr` and `n` were updated.
+ */
+void arraylist_hash_inserted_range(ArrayList *list, size_t position, size_t count);
+
+/**
+ * @brief Records in the hash index that insert_indices() inserted `k` elements.
+ *
+ * Called after `arr` and `n` were updated; `sorted_idx` are the positions
+ * passed to insert_indices(), relative to the list before the insertion.
+ */
+void arraylist_hash_inserted_indices(ArrayList *list, const size_t *sorted_idx, size_t k);
+
+/**
+ * @brief Records in the hash index that the element at `position` is about to be removed.
+ *
+ * Called before `arr` and `n` change; following elements shift down by one.
+ */
+void arraylist_hash_removing(ArrayList *list, size_t position);
+
+/**
+ * @brief Records in the hash index that the element at `position` is about
+ *        to be replaced by the last element.
+ *
+ * Called before `arr` and `n` change.
+ */
+void arraylist_hash_swap_removing(ArrayList *list, size_t position);
+
+/**
+ * @brief Looks an element up in the hash index without modifying it.
+ */
+ssize_t arraylist_hash_find(const ArrayList *list, const void *element);
+
+/**
+ * @struct ArrayListBloomFilter
+ * @brief Blocked Bloom filter over the elements of a list.
+ */
+struct ArrayListBloomFilter {
+    uint64_t (*hash)(const void *element);  /**< Hash function of the elements. */
+    int (*cmp)(const void *, const void *); /**< Comparator of the find() calls the filter serves. */
+    uint64_t *blocks;          /**< `block_count` cache-line aligned blocks of 512 bits. */
+    size_t block_count;        /**< Number of blocks. */
+    void *storage;             /**< Allocation holding `blocks`. */
+    size_t storage_bytes;      /**< Size of `storage` in bytes. */
+    size_t bits_per_element;   /**< Filter bits planned per element. */
+    unsigned probes;           /**< Bits set per element. */
+    size_t capacity;           /**< Elements the filter was sized for. */
+    size_t inserted;           /**< Elements added since the last rebuild. */
+    ArrayListBloomStats stats; /**< Lookup counters, updated atomically by find(). */
+};
+
+/**
+ * @brief Adds elements to the Bloom filter, if the list has one.
+ *
+ * Called after the elements were stored in the list.
+ */
+void arraylist_bloom_add(ArrayList *list, const void *const *elements, size_t count);
+
+/**
+ * @brief Tells whether the Bloom filter proves `element` absent, updating its counters.
+ */
+bool arraylist_bloom_rejects(const ArrayList *list, const void *element);
+
+/**
+ * @brief Counts a lookup the Bloom filter let through that found nothing.
+ */
+void arraylist_bloom_missed(const ArrayList *list);
+
+/**
+ * @brief Flag set on lists whose structure belongs to the caller, see init_in_place().
+ *
+ * Kept in `flags` next to the public `ARRAYLIST_*` flags, from the top bit down.
+ */
+#define ARRAYLIST_BORROWED_STRUCTURE 0x80000000u
+
+/**
+ * @struct ArrayListExtension
+ * @brief Rarely used state of an ArrayList, allocated on first use.
+ */
+struct ArrayListExtension {
+    ArrayListGrowthPolicy growth;        /**< How the capacity grows when the list is full. */
+    size_t reserved;                     /**< Bytes of address space reserved or mapped for `arr`, if any. */
+    size_t mmap_threshold;               /**< Buffer size in bytes from which `arr` moves to its own mapping; 0 disables. */
+    size_t inline_bytes;                 /**< Bytes of slots allocated with the structure by init_small(), once they were left behind. */
+    int (*sorted_by)(const void *, const void *); /**< Comparator the elements are known to be sorted by, or NULL. */
+    ArrayListSearchIndex *search_index;  /**< Key index built by build_search_index(), or NULL. */
+    ArrayListHashIndex *hash_index;      /**< Hash index attached by attach_hash_index(), or NULL. */
+    ArrayListBloomFilter *bloom_filter;  /**< Bloom filter attached by attach_bloom_filter(), or NULL. */
+};
+
+/**
+ * @brief Extension holding the defaults, seen by lists that have none.
+ */
+extern const ArrayListExtension arraylist_default_extension;
+
+/**
+ * @brief Returns the extension of a list for reading, never NULL.
+ */
+static inline const ArrayListExtension *arraylist_extension(const ArrayList *list) {
+    return list->extension != NULL ? list->extension : &arraylist_default_extension;
+}
+
+/**
+ * @brief Returns the extension of a list for writing, allocating it on first use.
+ */
+ArrayListExtension *arraylist_ensure_extension(ArrayList *list);
+
+#endif // ARRAYLIST_INTERNAL_H
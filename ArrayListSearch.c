@@ -0,0 +1,433 @@
+/**
+ * @file ArrayListSearch.c
+ * @brief Comparator-free searches over ArrayList elements.
+ *
+ * This covers pointer-identity scans, in-element key scans and the
+ * Eytzinger search index.
+ *
+ * For the pointer-identity searches, on x86-64 the scans compare several
+ * pointers per instruction and the widest instruction set supported by
+ * the running CPU (AVX-512, AVX2 or the baseline SSE2) is picked the
+ * first time each search is used. Other targets use the scalar loops.
+ */
+
+#include "ArrayList.h"
+#include "ArrayListInternal.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && !defined(__ILP32__) && (defined(__GNUC__) || defined(__clang__))
+#define ARRAYLIST_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Kernel returning the index of the first match of `ptr` in `arr[0, n)`, or `n`.
+ */
+typedef size_t (*FindKernel)(void *const *arr, size_t n, const void *ptr);
+
+/**
+ * @brief Kernel returning the number of occurrences of `ptr` in `arr[0, n)`.
+ */
+typedef size_t (*CountKernel)(void *const *arr, size_t n, const void *ptr);
+
+static size_t find_first_scalar(void *const *arr, const size_t n, const void *ptr) {
+    for (size_t i = 0; i < n; i++) {
+        if (arr[i] == ptr) return i;
+    }
+    return n;
+}
+
+static size_t find_last_scalar(void *const *arr, const size_t n, const void *ptr) {
+    for (size_t i = n; i-- > 0;) {
+        if (arr[i] == ptr) return i;
+    }
+    return n;
+}
+
+static size_t count_scalar(void *const *arr, const size_t n, const void *ptr) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += arr[i] == ptr;
+    }
+    return count;
+}
+
+#ifdef ARRAYLIST_X86_DISPATCH
+
+/**
+ * @brief Compares two pointers per lane; SSE2 lacks a 64-bit compare, so
+ *        both 32-bit halves must match.
+ */
+static inline int sse2_match_mask(void *const *arr, const __m128i needle) {
+    const __m128i eq32 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)arr), needle);
+    const __m128i eq64 = _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(eq64));
+}
+
+static size_t find_first_sse2(void *const *arr, const size_t n, const void *ptr) {
+    const __m128i needle = _mm_set1_epi64x((long long)(uintptr_t)ptr);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const int mask = sse2_match_mask(arr + i, needle);
+        if (mask != 0) return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+    return i < n && arr[i] == ptr ? i : n;
+}
+
+static size_t find_last_sse2(void *const *arr, const size_t n, const void *ptr) {
+    const __m128i needle = _mm_set1_epi64x((long long)(uintptr_t)ptr);
+    size_t i = n;
+    for (; i >= 2; i -= 2) {
+        const int mask = sse2_match_mask(arr + i - 2, needle);
+        if (mask != 0) return i - 2 + (mask >> 1);
+    }
+    return i == 1 && arr[0] == ptr ? 0 : n;
+}
+
+static size_t count_sse2(void *const *arr, const size_t n, const void *ptr) {
+    const __m128i needle = _mm_set1_epi64x((long long)(uintptr_t)ptr);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        count += (size_t)__builtin_popcount((unsigned)sse2_match_mask(arr + i, needle));
+    }
+    return count + (i < n && arr[i] == ptr);
+}
+
+__attribute__((target("avx2")))
+static size_t find_first_avx2(void *const *arr, const size_t n, const void *ptr) {
+    const __m256i needle = _mm256_set1_epi64x((long long)(uintptr_t)ptr);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(arr + i)), needle);
+        const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (mask != 0) return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+    const size_t tail = find_first_scalar(arr + i, n - i, ptr);
+    return tail == n - i ? n : i + tail;
+}
+
+__attribute__((target("avx2")))
+static size_t find_last_avx2(void *const *arr, const size_t n, const void *ptr) {
+    const __m256i needle = _mm256_set1_epi64x((long long)(uintptr_t)ptr);
+    size_t i = n;
+    for (; i >= 4; i -= 4) {
+        const __m256i eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(arr + i - 4)), needle);
+        const int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (mask != 0) return i - 4 + (size_t)(31 - __builtin_clz((unsigned)mask));
+    }
+    const size_t head = find_last_scalar(arr, i, ptr);
+    return head == i ? n : head;
+}
+
+__attribute__((target("avx2")))
+static size_t count_avx2(void *const *arr, const size_t n, const void *ptr) {
+    const __m256i needle = _mm256_set1_epi64x((long long)(uintptr_t)ptr);
+    __m256i counts = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // Matching lanes are all ones, i.e. -1: subtracting them counts up.
+        counts = _mm256_sub_epi64(counts, _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(arr + i)), needle));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, counts);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + count_scalar(arr + i, n - i, ptr);
+}
+
+__attribute__((target("avx512f")))
+static size_t find_first_avx512(void *const *arr, const size_t n, const void *ptr) {
+    const __m512i needle = _mm512_set1_epi64((long long)(uintptr_t)ptr);
+    for (size_t i = 0; i < n; i += 8) {
+        const __mmask8 valid = n - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        const __m512i v = _mm512_maskz_loadu_epi64(valid, arr + i);
+        const __mmask8 mask = _mm512_mask_cmpeq_epi64_mask(valid, v, needle);
+        if (mask != 0) return i + (size_t)__builtin_ctz(mask);
+    }
+    return n;
+}
+
+__attribute__((target("avx512f")))
+static size_t find_last_avx512(void *const *arr, const size_t n, const void *ptr) {
+    const __m512i needle = _mm512_set1_epi64((long long)(uintptr_t)ptr);
+    size_t i = n;
+    for (; i >= 8; i -= 8) {
+        const __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(arr + i - 8), needle);
+        if (mask != 0) return i - 8 + (size_t)(31 - __builtin_clz(mask));
+    }
+    if (i > 0) {
+        const __mmask8 valid = (__mmask8)((1u << i) - 1);
+        const __mmask8 mask = _mm512_mask_cmpeq_epi64_mask(valid, _mm512_maskz_loadu_epi64(valid, arr), needle);
+        if (mask != 0) return (size_t)(31 - __builtin_clz(mask));
+    }
+    return n;
+}
+
+__attribute__((target("avx512f")))
+static size_t count_avx512(void *const *arr, const size_t n, const void *ptr) {
+    const __m512i needle = _mm512_set1_epi64((long long)(uintptr_t)ptr);
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += 8) {
+        const __mmask8 valid = n - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        const __m512i v = _mm512_maskz_loadu_epi64(valid, arr + i);
+        count += (size_t)__builtin_popcount(_mm512_mask_cmpeq_epi64_mask(valid, v, needle));
+    }
+    return count;
+}
+
+static FindKernel find_first_kernel;
+static FindKernel find_last_kernel;
+static CountKernel count_kernel;
+
+/**
+ * @brief Picks the kernels for the running CPU.
+ *
+ * Racing threads all store the same pointers, so no locking is needed.
+ */
+static void resolve_kernels(void) {
+    __builtin_cpu_init();
+    FindKernel first = find_first_sse2;
+    FindKernel last = find_last_sse2;
+    CountKernel count = count_sse2;
+    if (__builtin_cpu_supports("avx512f")) {
+        first = find_first_avx512;
+        last = find_last_avx512;
+        count = count_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        first = find_first_avx2;
+        last = find_last_avx2;
+        count = count_avx2;
+    }
+    __atomic_store_n(&find_last_kernel, last, __ATOMIC_RELAXED);
+    __atomic_store_n(&count_kernel, count, __ATOMIC_RELAXED);
+    __atomic_store_n(&find_first_kernel, first, __ATOMIC_RELEASE);
+}
+
+#define KERNEL(name) \
+    (__atomic_load_n(&find_first_kernel, __ATOMIC_ACQUIRE) == NULL ? resolve_kernels() : (void)0, \
+     __atomic_load_n(&name, __ATOMIC_RELAXED))
+
+#else
+
+#define KERNEL(name) name
+#define find_first_kernel find_first_scalar
+#define find_last_kernel find_last_scalar
+#define count_kernel count_scalar
+
+#endif // ARRAYLIST_X86_DISPATCH
+
+/**
+ * @brief Finds the first element that is the given pointer.
+ *
+ * Compares pointer identity only, without calling a comparator. On x86-64
+ * the scan uses the widest SIMD instruction set the CPU supports.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param ptr Pointer to look for.
+ * @return Index of the first occurrence if found, -1 otherwise.
+ */
+ssize_t find_ptr(const ArrayList *list, const void *ptr) {
+    const size_t i = KERNEL(find_first_kernel)(list->arr, list->n, ptr);
+    return i == list->n ? -1 : (ssize_t)i;
+}
+
+/**
+ * @brief Finds the last element that is the given pointer.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param ptr Pointer to look for.
+ * @return Index of the last occurrence if found, -1 otherwise.
+ */
+ssize_t find_ptr_last(const ArrayList *list, const void *ptr) {
+    const size_t i = KERNEL(find_last_kernel)(list->arr, list->n, ptr);
+    return i == list->n ? -1 : (ssize_t)i;
+}
+
+/**
+ * @brief Counts the elements that are the given pointer.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param ptr Pointer to look for.
+ * @return Number of occurrences of `ptr`.
+ */
+size_t count_ptr(const ArrayList *list, const void *ptr) {
+    return KERNEL(count_kernel)(list->arr, list->n, ptr);
+}
+
+/**
+ * @brief Defines a scan comparing a `type`-wide key at `key_offset` inside each element.
+ *
+ * The key is read with `memcpy`, so it needs no particular alignment; the
+ * compiler turns the copy into a single load.
+ */
+#define DEFINE_KEY_SCAN(name, type)                                                    \
+    static size_t name(void *const *arr, const size_t n, const size_t key_offset,     \
+                       const void *key) {                                              \
+        type wanted;                                                                   \
+        memcpy(&wanted, key, sizeof(type));                                            \
+        for (size_t i = 0; i < n; i++) {                                               \
+            type value;                                                                \
+            memcpy(&value, (const unsigned char *)arr[i] + key_offset, sizeof(type));  \
+            if (value == wanted) return i;                                             \
+        }                                                                              \
+        return n;                                                                      \
+    }
+
+DEFINE_KEY_SCAN(find_key8, uint8_t)
+DEFINE_KEY_SCAN(find_key16, uint16_t)
+DEFINE_KEY_SCAN(find_key32, uint32_t)
+DEFINE_KEY_SCAN(find_key64, uint64_t)
+
+/**
+ * @brief Finds an element by a fixed-width key stored inside it.
+ *
+ * Compares `key_width` bytes at `key_offset` within each element against
+ * `key`, with no comparator call per element. Widths of 1, 2, 4 and 8
+ * bytes compare as integers; any other width is compared with `memcmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param key_offset Offset in bytes of the key inside each element, e.g.
+ *                   from `offsetof`.
+ * @param key_width Size in bytes of the key.
+ * @param key Pointer to the `key_width` bytes to look for.
+ * @return Index of the first element whose key matches, -1 otherwise.
+ */
+ssize_t find_by_key(const ArrayList *list, const size_t key_offset, const size_t key_width, const void *key) {
+    size_t i;
+    switch (key_width) {
+        case 1: i = find_key8(list->arr, list->n, key_offset, key); break;
+        case 2: i = find_key16(list->arr, list->n, key_offset, key); break;
+        case 4: i = find_key32(list->arr, list->n, key_offset, key); break;
+        case 8: i = find_key64(list->arr, list->n, key_offset, key); break;
+        default:
+            for (i = 0; i < list->n; i++) {
+                if (memcmp((const unsigned char *)list->arr[i] + key_offset, key, key_width) == 0) break;
+            }
+            break;
+    }
+    return i == list->n ? -1 : (ssize_t)i;
+}
+
+/**
+ * @brief Cache line size assumed when laying out the search index.
+ */
+#define SEARCH_INDEX_LINE 64
+
+/**
+ * @struct FillCursor
+ * @brief Walks the list front to back while the index tree is filled in order.
+ */
+typedef struct FillCursor {
+    void *const *arr; /**< Elements of the list. */
+    size_t next;      /**< Index of the next element to place. */
+    uint64_t prev;    /**< Key of the previously placed element. */
+    bool sorted;      /**< Whether the keys seen so far are non-decreasing. */
+} FillCursor;
+
+/**
+ * @brief Places the next elements of the list into the subtree rooted at slot `k`.
+ *
+ * An in-order traversal of the tree visits the list front to back.
+ */
+static void fill_eytzinger(ArrayListSearchIndex *index, FillCursor *cursor, const size_t k) {
+    if (k > index->n) return;
+    fill_eytzinger(index, cursor, 2 * k);
+    const uint64_t key = index->key_fn(cursor->arr[cursor->next]);
+    if (cursor->next > 0 && key < cursor->prev) cursor->sorted = false;
+    index->keys[k] = key;
+    index->positions[k] = cursor->next;
+    cursor->prev = key;
+    cursor->next++;
+    fill_eytzinger(index, cursor, 2 * k + 1);
+}
+
+/**
+ * @brief (Re)builds the index of `list` in place.
+ */
+static void rebuild_search_index(ArrayList *list) {
+    ArrayListSearchIndex *index = arraylist_extension(list)->search_index;
+    const ArrayListAllocator *allocator = list->allocator;
+    const size_t slots = list->n + 1; // Slot 0 is unused
+    const size_t bytes = SEARCH_INDEX_LINE + slots * (sizeof(uint64_t) + sizeof(size_t));
+    if (bytes > index->block_bytes) {
+        if (index->block != NULL) allocator->deallocate(allocator->ctx, index->block, index->block_bytes);
+        index->block = allocator->allocate(allocator->ctx, bytes);
+        if (index->block == NULL) THROW_ERROR("out of memory");
+        index->block_bytes = bytes;
+    }
+    const uintptr_t aligned = ((uintptr_t)index->block + SEARCH_INDEX_LINE - 1) & ~(uintptr_t)(SEARCH_INDEX_LINE - 1);
+    index->keys = (uint64_t *)aligned;
+    index->positions = (size_t *)(index->keys + slots);
+    index->n = list->n;
+    FillCursor cursor = {.arr = list->arr, .next = 0, .prev = 0, .sorted = true};
+    fill_eytzinger(index, &cursor, 1);
+    if (!cursor.sorted) THROW_ERROR("list not sorted by key");
+    index->stale = false;
+}
+
+/**
+ * @brief Builds a cache-friendly search index over the keys of a sorted ArrayList.
+ *
+ * Extracts the key of every element once and stores the keys in
+ * Eytzinger (BFS) order next to the list, so that search_index_find()
+ * runs a branchless, prefetching search instead of a binary search that
+ * misses cache at every level. The list must be sorted by key. Any
+ * mutation marks the index stale, and the next search rebuilds it.
+ *
+ * @param list Pointer to the ArrayList, sorted by `key_fn`.
+ * @param key_fn Function returning the key of an element.
+ */
+void build_search_index(ArrayList *list, uint64_t (*key_fn)(const void *element)) {
+    ArrayListExtension *extension = arraylist_ensure_extension(list);
+    if (extension->search_index == NULL) {
+        const ArrayListAllocator *allocator = list->allocator;
+        ArrayListSearchIndex *index = allocator->allocate(allocator->ctx, sizeof(ArrayListSearchIndex));
+        if (index == NULL) THROW_ERROR("out of memory");
+        index->block = NULL;
+        index->block_bytes = 0;
+        extension->search_index = index;
+    }
+    extension->search_index->key_fn = key_fn;
+    rebuild_search_index(list);
+}
+
+/**
+ * @brief Finds an element by key using the search index.
+ *
+ * Rebuilds the index first if the list changed since it was built.
+ *
+ * @param list Pointer to the ArrayList with a search index.
+ * @param key Key to look for.
+ * @return Index of the first element with that key if found, -1 otherwise.
+ */
+ssize_t search_index_find(ArrayList *list, const uint64_t key) {
+    ArrayListSearchIndex *index = arraylist_extension(list)->search_index;
+    if (index == NULL) THROW_ERROR("no search index");
+    if (index->stale) rebuild_search_index(list);
+    const uint64_t *keys = index->keys;
+    const size_t n = index->n;
+    size_t k = 1;
+    while (k <= n) {
+        // The descendants three levels down, 8k..8k+7, share one cache line.
+        __builtin_prefetch(keys + 8 * k);
+        k = 2 * k + (keys[k] < key);
+    }
+    // Undo the trailing right turns plus one left turn to land on the lower bound.
+    k >>= __builtin_ffsll((long long)~k);
+    if (k == 0 || keys[k] != key) return -1;
+    return (ssize_t)index->positions[k];
+}
+
+/**
+ * @brief Releases the search index of an ArrayList, if any.
+ *
+ * @param list Pointer to the ArrayList.
+ */
+void free_search_index(ArrayList *list) {
+    ArrayListSearchIndex *index = arraylist_extension(list)->search_index;
+    if (index == NULL) return;
+    const ArrayListAllocator *allocator = list->allocator;
+    if (index->block != NULL) allocator->deallocate(allocator->ctx, index->block, index->block_bytes);
+    allocator->deallocate(allocator->ctx, index, sizeof(ArrayListSearchIndex));
+    list->extension->search_index = NULL;
+}
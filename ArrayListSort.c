@@ -0,0 +1,269 @@
+/**
+ * @file ArrayListSort.c
+ * @brief Sorting and ordered searches over ArrayList elements.
+ */
+
+#include "ArrayList.h"
+#include "ArrayListInternal.h"
+#include "ArrayListSortTemplate.h"
+#include <string.h>
+
+/**
+ * @brief Orders two elements with the comparator `ctx` points to.
+ */
+static inline bool slot_less(const void *a, const void *b, const void *ctx) {
+    int (*const cmp)(const void *, const void *) = *(int (*const *)(const void *, const void *))ctx;
+    return cmp(a, b) < 0;
+}
+
+ARRAYLIST_DEFINE_SORT(sort_slots, void *, slot_less)
+
+/**
+ * @brief Sorts the ArrayList.
+ *
+ * Uses a pattern-defeating quicksort working on the element slots
+ * directly: O(n log n) in the worst case, linear on sorted input, and
+ * without the adapter call per comparison of `qsort`. The order of equal
+ * elements is not preserved; see stable_sort().
+ *
+ * Afterwards the list is flagged as sorted by `cmp`: find() with the same
+ * comparator switches to binary search, and mutations keep or drop the
+ * flag as appropriate.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param cmp Comparator receiving two elements, as for find().
+ */
+void sort(ArrayList *list, int (*cmp)(const void *, const void *)) {
+    if (arraylist_extension(list)->sorted_by != cmp) {
+        sort_slots(list->arr, list->n, &cmp);
+        arraylist_reordered(list);
+    }
+    arraylist_ensure_extension(list)->sorted_by = cmp;
+}
+
+/**
+ * @brief Sorts the ArrayList, keeping equal elements in their current order.
+ *
+ * Uses a natural merge sort: existing ascending or descending runs are
+ * reused, so nearly sorted lists take close to linear time. Needs a
+ * temporary buffer of `n / 2` slots from the list's allocator.
+ *
+ * Afterwards the list is flagged as sorted by `cmp`, as with sort().
+ *
+ * @param list Pointer to the ArrayList.
+ * @param cmp Comparator receiving two elements, as for find().
+ */
+void stable_sort(ArrayList *list, int (*cmp)(const void *, const void *)) {
+    if (arraylist_extension(list)->sorted_by != cmp && list->n > 1) {
+        const ArrayListAllocator *allocator = list->allocator;
+        const size_t scratch_bytes = list->n / 2 * sizeof(void *);
+        void **scratch = allocator->allocate(allocator->ctx, scratch_bytes);
+        if (scratch == NULL) THROW_ERROR("out of memory");
+        sort_slots_stable(list->arr, list->n, scratch, &cmp);
+        allocator->deallocate(allocator->ctx, scratch, scratch_bytes);
+        arraylist_reordered(list);
+    }
+    arraylist_ensure_extension(list)->sorted_by = cmp;
+}
+
+/** Bits of the key consumed by each pass of the radix sorts. */
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1u << RADIX_BITS)
+
+/**
+ * @brief Defines an LSD radix sort of the list by an unsigned key of `type`.
+ *
+ * Keys are extracted once into a temporary array kept next to the element
+ * slots (structure of arrays), so the passes never touch the elements
+ * themselves. The histograms of every digit are built in that same first
+ * pass, and passes whose digit is equal for all keys are skipped.
+ */
+#define DEFINE_RADIX_SORT(name, type)                                                      \
+    static void name(ArrayList *list, type (*key)(const void *element)) {                  \
+        const size_t n = list->n;                                                          \
+        if (n < 2) return;                                                                 \
+        enum { digits = sizeof(type) * 8 / RADIX_BITS };                                   \
+        const ArrayListAllocator *allocator = list->allocator;                            \
+        const size_t bytes = 2 * n * sizeof(type) + n * sizeof(void *);                    \
+        type *keys = allocator->allocate(allocator->ctx, bytes);                          \
+        if (keys == NULL) THROW_ERROR("out of memory");                                    \
+        type *keys_tmp = keys + n;                                                         \
+        void **slots = list->arr;                                                          \
+        void **slots_tmp = (void **)(keys_tmp + n);                                        \
+        size_t counts[digits][RADIX_BUCKETS] = {0};                                        \
+        for (size_t i = 0; i < n; i++) {                                                   \
+            const type k = key(slots[i]);                                                  \
+            keys[i] = k;                                                                   \
+            for (unsigned d = 0; d < digits; d++) {                                        \
+                counts[d][(k >> (d * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;                \
+            }                                                                              \
+        }                                                                                  \
+        for (unsigned d = 0; d < digits; d++) {                                            \
+            const unsigned shift = d * RADIX_BITS;                                         \
+            size_t *offsets = counts[d];                                                   \
+            if (offsets[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n) continue;          \
+            size_t total = 0;                                                              \
+            for (unsigned b = 0; b < RADIX_BUCKETS; b++) {                                 \
+                const size_t count = offsets[b];                                           \
+                offsets[b] = total;                                                        \
+                total += count;                                                            \
+            }                                                                              \
+            for (size_t i = 0; i < n; i++) {                                               \
+                const size_t dst = offsets[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;    \
+                keys_tmp[dst] = keys[i];                                                   \
+                slots_tmp[dst] = slots[i];                                                 \
+            }                                                                              \
+            type *const keys_next = keys_tmp;                                              \
+            keys_tmp = keys;                                                               \
+            keys = keys_next;                                                              \
+            void **const slots_next = slots_tmp;                                           \
+            slots_tmp = slots;                                                             \
+            slots = slots_next;                                                            \
+        }                                                                                  \
+        if (slots != list->arr) memcpy(list->arr, slots, n * sizeof(void *));              \
+        allocator->deallocate(allocator->ctx, keys < keys_tmp ? keys : keys_tmp, bytes);   \
+        arraylist_reordered(list);                                                         \
+    }
+
+DEFINE_RADIX_SORT(radix_sort_u32, uint32_t)
+DEFINE_RADIX_SORT(radix_sort_u64, uint64_t)
+
+/**
+ * @brief Sorts the ArrayList by a 32-bit key with a radix sort.
+ *
+ * Runs in O(n) time with one `key` call per element, and keeps equal
+ * keys in their current order. Keys compare as unsigned integers: map
+ * signed keys by flipping the sign bit, and IEEE floats by flipping every
+ * bit of negative values and the sign bit of the others. Needs a
+ * temporary buffer of `n` slots and `2 * n` keys from the list's allocator.
+ *
+ * Having no comparator, the list is not flagged as sorted afterwards.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param key Function returning the sort key of an element.
+ */
+void sort_by_key_u32(ArrayList *list, uint32_t (*key)(const void *element)) {
+    radix_sort_u32(list, key);
+}
+
+/**
+ * @brief Sorts the ArrayList by a 64-bit key with a radix sort.
+ *
+ * Runs in O(n) time with one `key` call per element, and keeps equal
+ * keys in their current order. Keys compare as unsigned integers: map
+ * signed keys by flipping the sign bit, and IEEE floats by flipping every
+ * bit of negative values and the sign bit of the others. Needs a
+ * temporary buffer of `n` slots and `2 * n` keys from the list's allocator.
+ *
+ * Having no comparator, the list is not flagged as sorted afterwards.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param key Function returning the sort key of an element.
+ */
+void sort_by_key_u64(ArrayList *list, uint64_t (*key)(const void *element)) {
+    radix_sort_u64(list, key);
+}
+
+/**
+ * @brief Tells whether the ArrayList is sorted by a comparator.
+ *
+ * Answers from the sorted flag when it is set for `cmp`; otherwise checks
+ * the elements and sets the flag if they turn out to be sorted.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param cmp Comparator receiving two elements.
+ * @return true if the elements are in non-decreasing order under `cmp`.
+ */
+bool is_sorted(ArrayList *list, int (*cmp)(const void *, const void *)) {
+    if (arraylist_extension(list)->sorted_by == cmp) return true;
+    for (size_t i = 1; i < list->n; i++) {
+        if (cmp(list->arr[i - 1], list->arr[i]) > 0) return false;
+    }
+    arraylist_ensure_extension(list)->sorted_by = cmp;
+    return true;
+}
+
+/**
+ * @brief Returns the index of the first element not less than `element`.
+ *
+ * The list must be sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param element Pointer to the element to compare against.
+ * @param cmp Comparator receiving two elements.
+ * @return Index in `[0, n]`.
+ */
+size_t lower_bound(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *)) {
+    size_t first = 0;
+    size_t count = list->n;
+    while (count > 0) {
+        const size_t half = count / 2;
+        if (cmp(list->arr[first + half], element) < 0) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Returns the index of the first element greater than `element`.
+ *
+ * The list must be sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param element Pointer to the element to compare against.
+ * @param cmp Comparator receiving two elements.
+ * @return Index in `[0, n]`.
+ */
+size_t upper_bound(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *)) {
+    size_t first = 0;
+    size_t count = list->n;
+    while (count > 0) {
+        const size_t half = count / 2;
+        if (cmp(list->arr[first + half], element) <= 0) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Finds an element in a sorted ArrayList with binary search.
+ *
+ * The list must be sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList.
+ * @param element Pointer to the element to find.
+ * @param cmp Comparator receiving two elements.
+ * @return Index of the first equal element if found, -1 otherwise.
+ */
+ssize_t binary_find(const ArrayList *list, const void *element, int (*cmp)(const void *, const void *)) {
+    const size_t i = lower_bound(list, element, cmp);
+    if (i < list->n && cmp(list->arr[i], element) == 0) {
+        return (ssize_t)i;
+    }
+    return -1; // Element not found
+}
+
+/**
+ * @brief Inserts an element at its ordered position in a sorted ArrayList.
+ *
+ * The element goes after any equal elements, and the list stays flagged
+ * as sorted by `cmp`.
+ *
+ * @param list Pointer to the ArrayList, sorted by `cmp`.
+ * @param element Pointer to the element to insert.
+ * @param cmp Comparator receiving two elements.
+ * @return Index at which the element was inserted.
+ */
+size_t insert_sorted(ArrayList *list, const void *element, int (*cmp)(const void *, const void *)) {
+    const size_t index = upper_bound(list, element, cmp);
+    insert_at(list, element, index);
+    return index;
+}
@@ -0,0 +1,397 @@
+/**
+ * @file ArrayListSortTemplate.h
+ * @brief Macro-generated sorts with an inlined comparison.
+ *
+ * ARRAYLIST_DEFINE_SORT(name, T, LESS) expands to two `static inline` functions
+ * sorting arrays of `T` in place:
+ *
+ * - `name(T *base, size_t n, const void *ctx)`, a pattern-defeating
+ *   quicksort: median-of-three or ninther pivots, insertion sort below
+ *   ARRAYLIST_SORT_INSERTION_THRESHOLD elements, a linear pass over
+ *   inputs that are already sorted, and a heapsort fallback after too
+ *   many unbalanced partitions, so the worst case stays O(n log n). Not
+ *   stable.
+ * - `name_stable(T *base, size_t n, T *scratch, const void *ctx)`, a
+ *   natural merge sort in the style of timsort: ascending and strictly
+ *   descending runs are detected, short runs are extended with binary
+ *   insertion sort, and runs are merged under the timsort stack
+ *   invariants. `scratch` must hold at least `n / 2` elements.
+ *
+ * `LESS(a, b, ctx)` is a function or macro taking two `T` values and the
+ * `ctx` passed to the sort, and returning true when `a` orders before
+ * `b`. Because it is expanded in place, a simple comparison compiles to a
+ * single instruction instead of an indirect call per comparison, as
+ * `qsort` makes.
+ *
+ * @code
+ * #define INT_LESS(a, b, ctx) ((a) < (b))
+ * ARRAYLIST_DEFINE_SORT(int_sort, int, INT_LESS)
+ *
+ * int_sort(values, count, NULL);
+ * @endcode
+ */
+
+#ifndef ARRAYLIST_SORT_TEMPLATE_H
+#define ARRAYLIST_SORT_TEMPLATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/** Ranges shorter than this are finished with insertion sort. */
+#define ARRAYLIST_SORT_INSERTION_THRESHOLD 24
+
+/** Ranges longer than this pick the pivot as a ninther instead of a median of three. */
+#define ARRAYLIST_SORT_NINTHER_THRESHOLD 128
+
+/** Moves after which an optimistic insertion sort of a partitioned range gives up. */
+#define ARRAYLIST_SORT_PARTIAL_LIMIT 8
+
+/** Runs of the stable sort are extended to between this and twice this length. */
+#define ARRAYLIST_SORT_MIN_RUN 32
+
+/** Bound on pending runs of the stable sort, whose lengths grow like Fibonacci numbers. */
+#define ARRAYLIST_SORT_MAX_RUNS 96
+
+/**
+ * @brief Defines the sorts `name` and `name_stable` over arrays of `T`.
+ *
+ * @param name Name of the unstable sort, also used as prefix of the helpers.
+ * @param T Element type.
+ * @param LESS Strict ordering `LESS(a, b, ctx)`.
+ */
+#define ARRAYLIST_DEFINE_SORT(name, T, LESS)                                                    \
+    static inline void name##_swap(T *a, T *b) {                                                \
+        T tmp = *a;                                                                             \
+        *a = *b;                                                                                \
+        *b = tmp;                                                                               \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_sort2(T *a, T *b, const void *ctx) {                              \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        if (LESS(*b, *a, ctx)) name##_swap(a, b);                                               \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_sort3(T *a, T *b, T *c, const void *ctx) {                        \
+        name##_sort2(a, b, ctx);                                                                \
+        name##_sort2(b, c, ctx);                                                                \
+        name##_sort2(a, b, ctx);                                                                \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_insertion(T *begin, T *end, const void *ctx) {                    \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        if (begin == end) return;                                                               \
+        for (T *cur = begin + 1; cur != end; cur++) {                                           \
+            T *sift = cur;                                                                      \
+            T *sift_1 = cur - 1;                                                                \
+            if (LESS(*sift, *sift_1, ctx)) {                                                    \
+                T tmp = *sift;                                                                  \
+                do {                                                                            \
+                    *sift-- = *sift_1;                                                          \
+                } while (sift != begin && LESS(tmp, *--sift_1, ctx));                           \
+                *sift = tmp;                                                                    \
+            }                                                                                   \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    /* Insertion sort relying on `begin[-1]` being no greater than any element. */              \
+    static inline void name##_insertion_unguarded(T *begin, T *end, const void *ctx) {          \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        if (begin == end) return;                                                               \
+        for (T *cur = begin + 1; cur != end; cur++) {                                           \
+            T *sift = cur;                                                                      \
+            T *sift_1 = cur - 1;                                                                \
+            if (LESS(*sift, *sift_1, ctx)) {                                                    \
+                T tmp = *sift;                                                                  \
+                do {                                                                            \
+                    *sift-- = *sift_1;                                                          \
+                } while (LESS(tmp, *--sift_1, ctx));                                            \
+                *sift = tmp;                                                                    \
+            }                                                                                   \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    /* Insertion sort giving up once more than a few elements had to move. */                   \
+    static inline bool name##_insertion_partial(T *begin, T *end, const void *ctx) {            \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        if (begin == end) return true;                                                          \
+        size_t moved = 0;                                                                       \
+        for (T *cur = begin + 1; cur != end; cur++) {                                           \
+            T *sift = cur;                                                                      \
+            T *sift_1 = cur - 1;                                                                \
+            if (LESS(*sift, *sift_1, ctx)) {                                                    \
+                T tmp = *sift;                                                                  \
+                do {                                                                            \
+                    *sift-- = *sift_1;                                                          \
+                } while (sift != begin && LESS(tmp, *--sift_1, ctx));                           \
+                *sift = tmp;                                                                    \
+                moved += (size_t)(cur - sift);                                                  \
+                if (moved > ARRAYLIST_SORT_PARTIAL_LIMIT) return false;                         \
+            }                                                                                   \
+        }                                                                                       \
+        return true;                                                                            \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_sift_down(T *base, size_t root, const size_t n,                   \
+                                         const void *ctx) {                                     \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        T tmp = base[root];                                                                     \
+        for (;;) {                                                                              \
+            size_t child = 2 * root + 1;                                                        \
+            if (child >= n) break;                                                              \
+            if (child + 1 < n && LESS(base[child], base[child + 1], ctx)) child++;              \
+            if (!LESS(tmp, base[child], ctx)) break;                                            \
+            base[root] = base[child];                                                           \
+            root = child;                                                                       \
+        }                                                                                       \
+        base[root] = tmp;                                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_heapsort(T *begin, T *end, const void *ctx) {                     \
+        const size_t n = (size_t)(end - begin);                                                 \
+        for (size_t i = n / 2; i-- > 0;) name##_sift_down(begin, i, n, ctx);                    \
+        for (size_t i = n; i-- > 1;) {                                                          \
+            name##_swap(begin, begin + i);                                                      \
+            name##_sift_down(begin, 0, i, ctx);                                                 \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    /* Puts elements less than the pivot `*begin` left of it; reports whether */                \
+    /* the range was already partitioned. Returns the pivot position.         */                \
+    static inline T *name##_partition_right(T *begin, T *end, bool *already, const void *ctx) { \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        T pivot = *begin;                                                                       \
+        T *first = begin;                                                                       \
+        T *last = end;                                                                          \
+        while (LESS(*++first, pivot, ctx)) {}                                                   \
+        if (first - 1 == begin) {                                                               \
+            while (first < last && !LESS(*--last, pivot, ctx)) {}                               \
+        } else {                                                                                \
+            while (!LESS(*--last, pivot, ctx)) {}                                               \
+        }                                                                                       \
+        *already = first >= last;                                                               \
+        while (first < last) {                                                                  \
+            name##_swap(first, last);                                                           \
+            while (LESS(*++first, pivot, ctx)) {}                                               \
+            while (!LESS(*--last, pivot, ctx)) {}                                               \
+        }                                                                                       \
+        T *pivot_pos = first - 1;                                                               \
+        *begin = *pivot_pos;                                                                    \
+        *pivot_pos = pivot;                                                                     \
+        return pivot_pos;                                                                       \
+    }                                                                                           \
+                                                                                                \
+    /* Puts elements equal to the pivot `*begin` left of it, used when the */                   \
+    /* pivot repeats the element bounding the range. Returns its position. */                   \
+    static inline T *name##_partition_left(T *begin, T *end, const void *ctx) {                 \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        T pivot = *begin;                                                                       \
+        T *first = begin;                                                                       \
+        T *last = end;                                                                          \
+        while (LESS(pivot, *--last, ctx)) {}                                                    \
+        if (last + 1 == end) {                                                                  \
+            while (first < last && !LESS(pivot, *++first, ctx)) {}                              \
+        } else {                                                                                \
+            while (!LESS(pivot, *++first, ctx)) {}                                              \
+        }                                                                                       \
+        while (first < last) {                                                                  \
+            name##_swap(first, last);                                                           \
+            while (LESS(pivot, *--last, ctx)) {}                                                \
+            while (!LESS(pivot, *++first, ctx)) {}                                              \
+        }                                                                                       \
+        T *pivot_pos = last;                                                                    \
+        *begin = *pivot_pos;                                                                    \
+        *pivot_pos = pivot;                                                                     \
+        return pivot_pos;                                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_loop(T *begin, T *end, int bad_allowed, bool leftmost,            \
+                                    const void *ctx) {                                          \
+        for (;;) {                                                                              \
+            const size_t size = (size_t)(end - begin);                                          \
+            if (size < ARRAYLIST_SORT_INSERTION_THRESHOLD) {                                    \
+                if (leftmost) {                                                                 \
+                    name##_insertion(begin, end, ctx);                                          \
+                } else {                                                                        \
+                    name##_insertion_unguarded(begin, end, ctx);                                \
+                }                                                                               \
+                return;                                                                         \
+            }                                                                                   \
+            const size_t s2 = size / 2;                                                         \
+            if (size > ARRAYLIST_SORT_NINTHER_THRESHOLD) {                                      \
+                name##_sort3(begin, begin + s2, end - 1, ctx);                                  \
+                name##_sort3(begin + 1, begin + (s2 - 1), end - 2, ctx);                        \
+                name##_sort3(begin + 2, begin + (s2 + 1), end - 3, ctx);                        \
+                name##_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), ctx);              \
+                name##_swap(begin, begin + s2);                                                 \
+            } else {                                                                            \
+                name##_sort3(begin + s2, begin, end - 1, ctx);                                  \
+            }                                                                                   \
+            if (!leftmost && !LESS(*(begin - 1), *begin, ctx)) {                                \
+                begin = name##_partition_left(begin, end, ctx) + 1;                             \
+                continue;                                                                       \
+            }                                                                                   \
+            bool already;                                                                       \
+            T *pivot_pos = name##_partition_right(begin, end, &already, ctx);                   \
+            const size_t l_size = (size_t)(pivot_pos - begin);                                  \
+            const size_t r_size = (size_t)(end - (pivot_pos + 1));                              \
+            if (l_size < size / 8 || r_size < size / 8) {                                       \
+                if (--bad_allowed == 0) {                                                       \
+                    name##_heapsort(begin, end, ctx);                                           \
+                    return;                                                                     \
+                }                                                                               \
+                if (l_size >= ARRAYLIST_SORT_INSERTION_THRESHOLD) {                             \
+                    name##_swap(begin, begin + l_size / 4);                                     \
+                    name##_swap(pivot_pos - 1, pivot_pos - l_size / 4);                         \
+                    if (l_size > ARRAYLIST_SORT_NINTHER_THRESHOLD) {                            \
+                        name##_swap(begin + 1, begin + (l_size / 4 + 1));                       \
+                        name##_swap(begin + 2, begin + (l_size / 4 + 2));                       \
+                        name##_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));               \
+                        name##_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));               \
+                    }                                                                           \
+                }                                                                               \
+                if (r_size >= ARRAYLIST_SORT_INSERTION_THRESHOLD) {                             \
+                    name##_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));                   \
+                    name##_swap(end - 1, end - r_size / 4);                                     \
+                    if (r_size > ARRAYLIST_SORT_NINTHER_THRESHOLD) {                            \
+                        name##_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));               \
+                        name##_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));               \
+                        name##_swap(end - 2, end - (1 + r_size / 4));                           \
+                        name##_swap(end - 3, end - (2 + r_size / 4));                           \
+                    }                                                                           \
+                }                                                                               \
+            } else if (already && name##_insertion_partial(begin, pivot_pos, ctx) &&            \
+                       name##_insertion_partial(pivot_pos + 1, end, ctx)) {                     \
+                return;                                                                         \
+            }                                                                                   \
+            name##_loop(begin, pivot_pos, bad_allowed, leftmost, ctx);                          \
+            begin = pivot_pos + 1;                                                              \
+            leftmost = false;                                                                   \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline void name(T *base, const size_t n, const void *ctx) {                         \
+        if (n < 2) return;                                                                      \
+        int bad_allowed = 0;                                                                    \
+        for (size_t m = n; m > 1; m >>= 1) bad_allowed++;                                       \
+        name##_loop(base, base + n, bad_allowed, true, ctx);                                    \
+    }                                                                                           \
+                                                                                                \
+    /* Length of the run at `base`, reversing it first if strictly descending. */               \
+    static inline size_t name##_run(T *base, const size_t n, const void *ctx) {                 \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        if (n < 2) return n;                                                                    \
+        size_t i = 1;                                                                           \
+        if (LESS(base[1], base[0], ctx)) {                                                      \
+            while (i + 1 < n && LESS(base[i + 1], base[i], ctx)) i++;                           \
+            for (size_t lo = 0, hi = i; lo < hi; lo++, hi--) name##_swap(base + lo, base + hi); \
+        } else {                                                                                \
+            while (i + 1 < n && !LESS(base[i + 1], base[i], ctx)) i++;                          \
+        }                                                                                       \
+        return i + 1;                                                                           \
+    }                                                                                           \
+                                                                                                \
+    /* Extends the sorted prefix `base[0, sorted)` to `base[0, n)`. */                          \
+    static inline void name##_binary_insertion(T *base, const size_t sorted, const size_t n,    \
+                                                const void *ctx) {                              \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        for (size_t i = sorted; i < n; i++) {                                                   \
+            T tmp = base[i];                                                                    \
+            size_t lo = 0;                                                                      \
+            size_t hi = i;                                                                      \
+            while (lo < hi) {                                                                   \
+                const size_t mid = lo + (hi - lo) / 2;                                          \
+                if (LESS(tmp, base[mid], ctx)) {                                                \
+                    hi = mid;                                                                   \
+                } else {                                                                        \
+                    lo = mid + 1;                                                               \
+                }                                                                               \
+            }                                                                                   \
+            memmove(base + lo + 1, base + lo, (i - lo) * sizeof(T));                            \
+            base[lo] = tmp;                                                                     \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    /* Merges the runs `base[0, mid)` and `base[mid, n)`, copying the shorter */                \
+    /* one to `scratch`.                                                      */                \
+    static inline void name##_merge(T *base, const size_t mid, const size_t n, T *scratch,      \
+                                     const void *ctx) {                                         \
+        (void)ctx; /* Unused when LESS ignores it. */                                           \
+        if (!LESS(base[mid], base[mid - 1], ctx)) return;                                       \
+        if (mid <= n - mid) {                                                                   \
+            memcpy(scratch, base, mid * sizeof(T));                                             \
+            T *a = scratch;                                                                     \
+            T *const a_end = scratch + mid;                                                     \
+            T *b = base + mid;                                                                  \
+            T *const b_end = base + n;                                                          \
+            T *out = base;                                                                      \
+            while (a < a_end && b < b_end) {                                                    \
+                *out++ = LESS(*b, *a, ctx) ? *b++ : *a++;                                       \
+            }                                                                                   \
+            memcpy(out, a, (size_t)(a_end - a) * sizeof(T));                                    \
+        } else {                                                                                \
+            memcpy(scratch, base + mid, (n - mid) * sizeof(T));                                 \
+            T *a = base + mid;                                                                  \
+            T *b = scratch + (n - mid);                                                         \
+            T *out = base + n;                                                                  \
+            while (a > base && b > scratch) {                                                   \
+                *--out = LESS(b[-1], a[-1], ctx) ? *--a : *--b;                                 \
+            }                                                                                   \
+            memcpy(base, scratch, (size_t)(b - scratch) * sizeof(T));                           \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_merge_at(T *base, size_t *run_start, size_t *run_len, size_t *runs, \
+                                       const size_t k, T *scratch, const void *ctx) {           \
+        const size_t merged = run_len[k] + run_len[k + 1];                                      \
+        name##_merge(base + run_start[k], run_len[k], merged, scratch, ctx);                    \
+        run_len[k] = merged;                                                                    \
+        if (k + 3 == *runs) {                                                                   \
+            run_start[k + 1] = run_start[k + 2];                                                \
+            run_len[k + 1] = run_len[k + 2];                                                    \
+        }                                                                                       \
+        (*runs)--;                                                                              \
+    }                                                                                           \
+                                                                                                \
+    static inline void name##_stable(T *base, const size_t n, T *scratch, const void *ctx) {    \
+        if (n < 2) return;                                                                      \
+        size_t min_run = n;                                                                     \
+        size_t odd = 0;                                                                         \
+        while (min_run >= 2 * ARRAYLIST_SORT_MIN_RUN) {                                         \
+            odd |= min_run & 1;                                                                 \
+            min_run >>= 1;                                                                      \
+        }                                                                                       \
+        min_run += odd;                                                                         \
+        size_t run_start[ARRAYLIST_SORT_MAX_RUNS];                                              \
+        size_t run_len[ARRAYLIST_SORT_MAX_RUNS];                                                \
+        size_t runs = 0;                                                                        \
+        for (size_t start = 0; start < n;) {                                                    \
+            size_t len = name##_run(base + start, n - start, ctx);                              \
+            if (len < min_run) {                                                                \
+                const size_t forced = n - start < min_run ? n - start : min_run;                \
+                name##_binary_insertion(base + start, len, forced, ctx);                        \
+                len = forced;                                                                   \
+            }                                                                                   \
+            run_start[runs] = start;                                                            \
+            run_len[runs] = len;                                                                \
+            runs++;                                                                             \
+            start += len;                                                                       \
+            while (runs > 1) {                                                                  \
+                size_t k = runs - 2;                                                            \
+                if ((k > 0 && run_len[k - 1] <= run_len[k] + run_len[k + 1]) ||                 \
+                    (k > 1 && run_len[k - 2] <= run_len[k - 1] + run_len[k])) {                 \
+                    if (run_len[k - 1] < run_len[k + 1]) k--;                                   \
+                } else if (run_len[k] > run_len[k + 1]) {                                       \
+                    break;                                                                      \
+                }                                                                               \
+                name##_merge_at(base, run_start, run_len, &runs, k, scratch, ctx);              \
+            }                                                                                   \
+        }                                                                                       \
+        while (runs > 1) {                                                                      \
+            size_t k = runs - 2;                                                                \
+            if (k > 0 && run_len[k - 1] < run_len[k + 1]) k--;                                  \
+            name##_merge_at(base, run_start, run_len, &runs, k, scratch, ctx);                  \
+        }                                                                                       \
+    }
+
+#endif // ARRAYLIST_SORT_TEMPLATE_H
@@ -0,0 +1,157 @@
+/**
+ * @file ArrayListTemplate.h
+ * @brief Macro-generated, type-specialized dynamic arrays.
+ *
+ * ARRAYLIST_DEFINE(name, T) expands to a list type `name` storing `T`
+ * values inline, together with `static inline` functions mirroring the
+ * ArrayList API (`name_init`, `name_push_back`, `name_find`, ...). Since
+ * the element type is concrete and every function is visible to the
+ * compiler, element copies need no casts and the equality passed to
+ * `name_find` can be inlined into the search loop.
+ *
+ * @code
+ * static inline bool int_eq(int a, int b) { return a == b; }
+ * ARRAYLIST_DEFINE(IntList, int)
+ *
+ * IntList *list = IntList_init(8);
+ * IntList_push_back(list, 42);
+ * ssize_t i = IntList_find(list, 42, int_eq);
+ * IntList_free(list);
+ * @endcode
+ */
+
+#ifndef ARRAYLIST_TEMPLATE_H
+#define ARRAYLIST_TEMPLATE_H
+
+#include "ArrayList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Prints an error to `stderr` and terminates, like THROW_ERROR in ArrayList.c.
+ */
+#define ARRAYLIST_TEMPLATE_ERROR(msg) \
+    (fprintf(stderr, "[ERROR] %s in function: %s\n", msg, __func__), exit(EXIT_FAILURE))
+
+/**
+ * @brief Defines the list type `name` holding elements of type `T` and its functions.
+ *
+ * @param name Name of the generated type, also used as prefix of the functions.
+ * @param T Element type, stored by value.
+ */
+#define ARRAYLIST_DEFINE(name, T)                                                              \
+    typedef struct name {                                                                      \
+        T *arr;                               /* Pointer to the array of elements. */          \
+        size_t n;                             /* Number of elements in the array. */           \
+        size_t length;                        /* Total capacity of the array. */               \
+        const ArrayListAllocator *allocator;  /* Allocator owning `arr` and the structure. */  \
+    } name;                                                                                    \
+                                                                                               \
+    static inline name *name##_init_with_allocator(const size_t length,                       \
+                                                   const ArrayListAllocator *allocator) {     \
+        if (length > SIZE_MAX / sizeof(T)) ARRAYLIST_TEMPLATE_ERROR("capacity too large");     \
+        if (allocator == NULL) allocator = default_allocator();                               \
+        name *list = allocator->allocate(allocator->ctx, sizeof(name));                       \
+        if (list == NULL) ARRAYLIST_TEMPLATE_ERROR("out of memory");                          \
+        list->arr = allocator->allocate(allocator->ctx, (length > 0 ? length : 1) * sizeof(T)); \
+        if (list->arr == NULL) {                                                               \
+            allocator->deallocate(allocator->ctx, list, sizeof(name));                        \
+            ARRAYLIST_TEMPLATE_ERROR("out of memory");                                        \
+        }                                                                                      \
+        list->n = 0;                                                                           \
+        list->length = length > 0 ? length : 1;                                                \
+        list->allocator = allocator;                                                           \
+        return list;                                                                           \
+    }                                                                                          \
+                                                                                               \
+    static inline name *name##_init(const size_t length) {                                    \
+        return name##_init_with_allocator(length, NULL);                                      \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_free(name *list) {                                               \
+        const ArrayListAllocator *allocator = list->allocator;                                \
+        allocator->deallocate(allocator->ctx, list->arr, list->length * sizeof(T));           \
+        allocator->deallocate(allocator->ctx, list, sizeof(name));                            \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_set_capacity(name *list, const size_t capacity) {               \
+        if (capacity > SIZE_MAX / sizeof(T)) ARRAYLIST_TEMPLATE_ERROR("capacity too large");   \
+        const ArrayListAllocator *allocator = list->allocator;                                \
+        T *newArr = allocator->reallocate(allocator->ctx, list->arr,                          \
+                                          list->length * sizeof(T), capacity * sizeof(T));    \
+        if (newArr == NULL) ARRAYLIST_TEMPLATE_ERROR("out of memory");                        \
+        list->arr = newArr;                                                                    \
+        list->length = capacity;                                                               \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_grow(name *list) {                                               \
+        if (list->length > (SIZE_MAX - 1) / 2) ARRAYLIST_TEMPLATE_ERROR("capacity too large"); \
+        name##_set_capacity(list, list->length * 2 + 1);                                       \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_resize(name *list, const size_t size) {                         \
+        if (size <= list->n) return;                                                           \
+        name##_set_capacity(list, size);                                                       \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_reserve(name *list, const size_t size) {                        \
+        if (size <= list->length) return;                                                      \
+        name##_set_capacity(list, size);                                                       \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_shrink_to_fit(name *list) {                                      \
+        const size_t capacity = list->n > 0 ? list->n : 1;                                     \
+        if (capacity == list->length) return;                                                  \
+        name##_set_capacity(list, capacity);                                                   \
+    }                                                                                          \
+                                                                                               \
+    static inline size_t name##_get_length(const name *list) {                                 \
+        return list->length;                                                                   \
+    }                                                                                          \
+                                                                                               \
+    static inline size_t name##_get_number_of_elements(const name *list) {                     \
+        return list->n;                                                                        \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_push_back(name *list, T element) {                               \
+        if (list->n == list->length) {                                                         \
+            name##_grow(list);                                                                 \
+        }                                                                                      \
+        list->arr[list->n++] = element;                                                        \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_pop_back(name *list) {                                           \
+        if (list->n == 0) {                                                                    \
+            fprintf(stderr, "[ERROR] Empty list in function: %s\n", __func__);                 \
+            return;                                                                            \
+        }                                                                                      \
+        list->n--;                                                                             \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_insert_at(name *list, T element, const size_t index) {           \
+        if (index > list->n) ARRAYLIST_TEMPLATE_ERROR("Index out of range");                  \
+        if (list->n == list->length) {                                                         \
+            name##_grow(list);                                                                 \
+        }                                                                                      \
+        memmove(&list->arr[index + 1], &list->arr[index], (list->n - index) * sizeof(T));     \
+        list->arr[index] = element;                                                            \
+        list->n++;                                                                             \
+    }                                                                                          \
+                                                                                               \
+    static inline void name##_remove_at(name *list, const size_t index) {                     \
+        if (index >= list->n) ARRAYLIST_TEMPLATE_ERROR("Index out of range");                 \
+        memmove(&list->arr[index], &list->arr[index + 1], (list->n - index - 1) * sizeof(T)); \
+        list->n--;                                                                             \
+    }                                                                                          \
+                                                                                               \
+    static inline ssize_t name##_find(const name *list, T element, bool (*eq)(T, T)) {         \
+        for (size_t i = 0; i < list->n; i++) {                                                 \
+            if (eq(list->arr[i], element)) {                                                   \
+                return (ssize_t)i;                                                             \
+            }                                                                                  \
+        }                                                                                      \
+        return -1;                                                                             \
+    }
+
+#endif // ARRAYLIST_TEMPLATE_H
@@ -0,0 +1,240 @@
+/**
+ * @file ValueList.c
+ * @brief Implementation of the ValueList functions.
+ */
+
+#include "ValueList.h"
+#include "ArrayListInternal.h"
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Initializes a ValueList.
+ *
+ * @param elem_size Size in bytes of each element; must be positive.
+ * @param length Initial capacity of the ValueList.
+ * @return Pointer to the initialized ValueList.
+ */
+ValueList* value_list_init(const size_t elem_size, const size_t length) {
+    return value_list_init_with_allocator(elem_size, length, NULL);
+}
+
+/**
+ * @brief Initializes a ValueList with a custom allocator.
+ *
+ * @param elem_size Size in bytes of each element; must be positive.
+ * @param length Initial capacity of the ValueList.
+ * @param allocator Allocator to use, or NULL for the default allocator.
+ * @return Pointer to the initialized ValueList.
+ */
+ValueList* value_list_init_with_allocator(const size_t elem_size, const size_t length,
+                                          const ArrayListAllocator *allocator) {
+    if (elem_size == 0) THROW_ERROR("element size must be positive");
+    if (length > SIZE_MAX / elem_size) THROW_ERROR("capacity too large");
+    if (allocator == NULL) allocator = default_allocator();
+    ValueList *list = allocator->allocate(allocator->ctx, sizeof(ValueList));
+    if (list == NULL) THROW_ERROR("out of memory");
+    // Allocate at least one element so that allocators are not asked for empty blocks.
+    list->data = allocator->allocate(allocator->ctx, (length > 0 ? length : 1) * elem_size);
+    if (list->data == NULL) {
+        allocator->deallocate(allocator->ctx, list, sizeof(ValueList));
+        THROW_ERROR("out of memory");
+    }
+    list->n = 0;
+    list->length = length > 0 ? length : 1;
+    list->elem_size = elem_size;
+    list->allocator = allocator;
+    return list;
+}
+
+/**
+ * @brief Frees the memory used by a ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ */
+void value_list_free(ValueList *list) {
+    const ArrayListAllocator *allocator = list->allocator;
+    allocator->deallocate(allocator->ctx, list->data, list->length * list->elem_size);
+    allocator->deallocate(allocator->ctx, list, sizeof(ValueList));
+}
+
+/**
+ * @brief Returns a pointer to the element at `index`.
+ *
+ * The pointer is invalidated by any operation that resizes the list.
+ *
+ * @param list Pointer to the ValueList.
+ * @param index Index of the element.
+ * @return Pointer to the element.
+ */
+void* value_list_at(const ValueList *list, const size_t index) {
+    if (index >= list->n) THROW_ERROR("Index out of range");
+    return list->data + index * list->elem_size;
+}
+
+/**
+ * @brief Moves the element buffer to a new capacity.
+ */
+static void set_capacity(ValueList *list, const size_t capacity) {
+    if (capacity > SIZE_MAX / list->elem_size) THROW_ERROR("capacity too large");
+    const ArrayListAllocator *allocator = list->allocator;
+    unsigned char *newData = allocator->reallocate(allocator->ctx, list->data,
+                                                   list->length * list->elem_size,
+                                                   capacity * list->elem_size);
+    if (newData == NULL) THROW_ERROR("out of memory");
+    list->data = newData;
+    list->length = capacity;
+}
+
+/**
+ * @brief Returns the byte offset of `element` in the buffer, or SIZE_MAX if it lies outside.
+ *
+ * Lets push and insert accept an element of the list itself, whose
+ * address the growth or the shift would otherwise invalidate.
+ */
+static size_t offset_in(const ValueList *list, const void *element) {
+    const uintptr_t data = (uintptr_t)list->data;
+    const uintptr_t address = (uintptr_t)element;
+    if (address < data || address - data >= list->n * list->elem_size) return SIZE_MAX;
+    return address - data;
+}
+
+/**
+ * @brief Copies an element to the end of the ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ * @param element Pointer to `elem_size` bytes to copy; may point into the list itself.
+ */
+void value_list_push_back(ValueList *list, const void *element) {
+    if (list->n == list->length) {
+        const size_t offset = offset_in(list, element);
+        set_capacity(list, list->length * 2 + 1);
+        if (offset != SIZE_MAX) element = list->data + offset;
+    }
+    memcpy(list->data + list->n * list->elem_size, element, list->elem_size);
+    list->n++;
+}
+
+/**
+ * @brief Removes the last element of the ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ */
+void value_list_pop_back(ValueList *list) {
+    if (list->n == 0) {
+        fprintf(stderr, "[ERROR] Empty list in function: %s\n", __func__);
+        return;
+    }
+    list->n--;
+}
+
+/**
+ * @brief Copies an element into a specific index of the ValueList.
+ *
+ * Shifts existing elements to the right to make space.
+ *
+ * @param list Pointer to the ValueList.
+ * @param element Pointer to `elem_size` bytes to copy; may point into the list itself.
+ * @param index Position at which to insert the element.
+ */
+void value_list_insert_at(ValueList *list, const void *element, const size_t index) {
+    if (index > list->n) {
+        THROW_ERROR("Index out of range");
+    }
+    const size_t size = list->elem_size;
+    size_t offset = offset_in(list, element);
+    if (list->n == list->length) {
+        set_capacity(list, list->length * 2 + 1);
+    }
+    unsigned char *slot = list->data + index * size;
+    memmove(slot + size, slot, (list->n - index) * size);
+    if (offset != SIZE_MAX) {
+        // The element moved with the buffer and, if at or after `index`, with the shift.
+        if (offset >= index * size) offset += size;
+        element = list->data + offset;
+    }
+    memcpy(slot, element, size);
+    list->n++;
+}
+
+/**
+ * @brief Removes the element at a specific index of the ValueList.
+ *
+ * Shifts the following elements to the left to fill the gap.
+ *
+ * @param list Pointer to the ValueList.
+ * @param index Index of the element to remove.
+ */
+void value_list_remove_at(ValueList *list, const size_t index) {
+    if (index >= list->n) {
+        THROW_ERROR("Index out of range");
+    }
+    const size_t size = list->elem_size;
+    unsigned char *slot = list->data + index * size;
+    memmove(slot, slot + size, (list->n - index - 1) * size);
+    list->n--;
+}
+
+/**
+ * @brief Resizes the ValueList to a new capacity.
+ *
+ * The new capacity must be greater than the current number of elements,
+ * otherwise the call has no effect.
+ *
+ * @param list Pointer to the ValueList.
+ * @param size New capacity for the ValueList.
+ */
+void value_list_resize(ValueList *list, const size_t size) {
+    if (size <= list->n) return;
+    set_capacity(list, size);
+}
+
+/**
+ * @brief Ensures the ValueList can hold at least `size` elements.
+ *
+ * @param list Pointer to the ValueList.
+ * @param size Minimum capacity for the ValueList.
+ */
+void value_list_reserve(ValueList *list, const size_t size) {
+    if (size <= list->length) return;
+    set_capacity(list, size);
+}
+
+/**
+ * @brief Shrinks the ValueList to the number of existing elements.
+ *
+ * @param list Pointer to the ValueList.
+ */
+void value_list_shrink_to_fit(ValueList *list) {
+    const size_t capacity = list->n > 0 ? list->n : 1;
+    if (capacity == list->length) return; // Already optimal
+    set_capacity(list, capacity);
+}
+
+/**
+ * @brief Finds an element in the ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ * @param element Pointer to the element to find.
+ * @param cmp Comparator receiving pointers to two elements, or NULL to
+ *            compare the raw bytes with `memcmp`.
+ * @return Index of the element if found, -1 otherwise.
+ */
+ssize_t value_list_find(const ValueList *list, const void *element, int (*cmp)(const void *, const void *)) {
+    const size_t size = list->elem_size;
+    const unsigned char *slot = list->data;
+    if (cmp == NULL) {
+        for (size_t i = 0; i < list->n; i++, slot += size) {
+            if (memcmp(slot, element, size) == 0) {
+                return (ssize_t)i;
+            }
+        }
+        return -1; // Element not found
+    }
+    for (size_t i = 0; i < list->n; i++, slot += size) {
+        if (cmp(slot, element) == 0) {
+            return (ssize_t)i;
+        }
+    }
+    return -1; // Element not found
+}
@@ -0,0 +1,139 @@
+/**
+ * @file ValueList.h
+ * @brief A dynamic array storing fixed-size elements by value.
+ *
+ * Unlike ArrayList, which stores `void*` pointers to elements living
+ * elsewhere, a ValueList copies each element into one contiguous buffer.
+ * Iterating touches a single dense block of memory instead of chasing a
+ * pointer per element.
+ */
+
+#ifndef VALUELIST_H
+#define VALUELIST_H
+
+#include "ArrayList.h"
+
+/**
+ * @struct ValueList
+ * @brief Represents a dynamic array of fixed-size elements stored inline.
+ */
+typedef struct ValueList {
+    unsigned char *data; /**< Pointer to the contiguous element storage. */
+    size_t n;            /**< Number of elements in the array. */
+    size_t length;       /**< Total capacity of the array, in elements. */
+    size_t elem_size;    /**< Size in bytes of each element. */
+    const ArrayListAllocator *allocator; /**< Allocator owning `data` and the structure itself. */
+} ValueList;
+
+/**
+ * @brief Initializes a ValueList.
+ *
+ * @param elem_size Size in bytes of each element; must be positive.
+ * @param length Initial capacity of the ValueList.
+ * @return Pointer to the initialized ValueList.
+ */
+ValueList* value_list_init(const size_t elem_size, const size_t length);
+
+/**
+ * @brief Initializes a ValueList with a custom allocator.
+ *
+ * @param elem_size Size in bytes of each element; must be positive.
+ * @param length Initial capacity of the ValueList.
+ * @param allocator Allocator to use, or NULL for the default allocator.
+ * @return Pointer to the initialized ValueList.
+ */
+ValueList* value_list_init_with_allocator(const size_t elem_size, const size_t length,
+                                          const ArrayListAllocator *allocator);
+
+/**
+ * @brief Frees the memory used by a ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ */
+void value_list_free(ValueList *list);
+
+/**
+ * @brief Returns a pointer to the element at `index`.
+ *
+ * The pointer is invalidated by any operation that resizes the list.
+ *
+ * @param list Pointer to the ValueList.
+ * @param index Index of the element.
+ * @return Pointer to the element.
+ */
+void* value_list_at(const ValueList *list, const size_t index);
+
+/**
+ * @brief Copies an element to the end of the ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ * @param element Pointer to `elem_size` bytes to copy; may point into the list itself.
+ */
+void value_list_push_back(ValueList *list, const void *element);
+
+/**
+ * @brief Removes the last element of the ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ */
+void value_list_pop_back(ValueList *list);
+
+/**
+ * @brief Copies an element into a specific index of the ValueList.
+ *
+ * Shifts existing elements to the right to make space.
+ *
+ * @param list Pointer to the ValueList.
+ * @param element Pointer to `elem_size` bytes to copy; may point into the list itself.
+ * @param index Position at which to insert the element.
+ */
+void value_list_insert_at(ValueList *list, const void *element, const size_t index);
+
+/**
+ * @brief Removes the element at a specific index of the ValueList.
+ *
+ * Shifts the following elements to the left to fill the gap.
+ *
+ * @param list Pointer to the ValueList.
+ * @param index Index of the element to remove.
+ */
+void value_list_remove_at(ValueList *list, const size_t index);
+
+/**
+ * @brief Resizes the ValueList to a new capacity.
+ *
+ * The new capacity must be greater than the current number of elements,
+ * otherwise the call has no effect.
+ *
+ * @param list Pointer to the ValueList.
+ * @param size New capacity for the ValueList.
+ */
+void value_list_resize(ValueList *list, const size_t size);
+
+/**
+ * @brief Ensures the ValueList can hold at least `size` elements.
+ *
+ * @param list Pointer to the ValueList.
+ * @param size Minimum capacity for the ValueList.
+ */
+void value_list_reserve(ValueList *list, const size_t size);
+
+/**
+ * @brief Shrinks the ValueList to the number of existing elements.
+ *
+ * @param list Pointer to the ValueList.
+ */
+void value_list_shrink_to_fit(ValueList *list);
+
+/**
+ * @brief Finds an element in the ValueList.
+ *
+ * @param list Pointer to the ValueList.
+ * @param element Pointer to the element to find.
+ * @param cmp Comparator receiving pointers to two elements, or NULL to
+ *            compare the raw bytes with `memcmp`.
+ * @return Index of the element if found, -1 otherwise.
+ */
+ssize_t value_list_find(const ValueList *list, const void *element, int (*cmp)(const void *, const void *));
+
+#endif // VALUELIST_H
@@ -0,0 +1,77 @@
+/**
+ * @file bench_remove.c
+ * @brief Measures remove_at throughput at 1K, 1M and 100M elements.
+ *
+ * Each operation removes the middle element and pushes a replacement, so
+ * the list keeps its size and every removal shifts half of it. The
+ * "remove_at" rows use the library, which shifts with libc memmove; the
+ * "loop" rows shift the same slots with the element-by-element loop
+ * remove_at used before, as a reference.
+ *
+ * Usage: bench_remove [max_elements], default 100000000 (800 MB of slots).
+ */
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+#include "ArrayList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Removes the element at `index` by shifting one slot at a time.
+ */
+static void loop_remove_at(ArrayList *list, const size_t index) {
+    void **volatile arr = list->arr; // Keep the compiler from turning the loop into memmove
+    for (size_t i = index; i + 1 < list->n; i++) {
+        arr[i] = arr[i + 1];
+    }
+    list->n--;
+    arr[list->n] = NULL;
+}
+
+/**
+ * @brief Times middle removals on a list of `n` elements.
+ *
+ * @param n Number of elements.
+ * @param use_loop Whether to shift with loop_remove_at() instead of remove_at().
+ */
+static void run(const size_t n, const bool use_loop) {
+    // Aim for about 4 GB of shifted slots per row.
+    const size_t ops = 1000000000 / n > 4 ? 1000000000 / n : 4;
+    ArrayList *list = init(n);
+    for (size_t i = 0; i < n; i++) {
+        push_back(list, (void *)(i + 1));
+    }
+    const double start = now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        if (use_loop) {
+            loop_remove_at(list, n / 2);
+        } else {
+            remove_at(list, n / 2);
+        }
+        push_back(list, (void *)i);
+    }
+    const double elapsed = now_ns() - start;
+    const double bytes = (double)ops * (double)(n - n / 2 - 1) * sizeof(void *);
+    printf("%-9s %12zu %10zu %14.1f %10.2f\n", use_loop ? "loop" : "remove_at", n, ops,
+           elapsed / (double)ops, bytes / elapsed);
+    freeArrayList(list);
+}
+
+int main(const int argc, char **argv) {
+    const size_t max_elements = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000000;
+    printf("%-9s %12s %10s %14s %10s\n", "shift", "elements", "ops", "ns/op", "GB/s");
+    static const size_t sizes[] = {1000, 1000000, 100000000};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= max_elements; i++) {
+        run(sizes[i], false);
+        run(sizes[i], true);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file bench_resize.c
+ * @brief Compares the realloc and mremap resize paths across list sizes.
+ *
+ * For each size the list is filled with push_back (growth from empty),
+ * then repeatedly doubled with resize() and cut back with
+ * shrink_to_fit(). The "realloc" rows use the allocator path; the
+ * "mremap" rows set an mmap threshold of one byte so every buffer lives
+ * in its own mapping.
+ *
+ * Usage: bench_resize [max_elements], default 100000000 (800 MB of slots).
+ */
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+#include "ArrayList.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Times filling and resizing a list of `n` elements.
+ *
+ * @param n Number of elements.
+ * @param mmap_threshold Threshold passed to set_mmap_threshold(), 0 for the realloc path.
+ */
+static void run(const size_t n, const size_t mmap_threshold) {
+    // Repeat small sizes so that each row covers roughly the same work.
+    const size_t rounds = n >= 10000000 ? 1 : 10000000 / n;
+    double fill_ns = 0;
+    double resize_ns = 0;
+    for (size_t r = 0; r < rounds; r++) {
+        ArrayList *list = init(0);
+        set_mmap_threshold(list, mmap_threshold);
+        double start = now_ns();
+        for (size_t i = 0; i < n; i++) {
+            push_back(list, (void *)(i + 1));
+        }
+        fill_ns += now_ns() - start;
+
+        start = now_ns();
+        for (int i = 0; i < 4; i++) {
+            resize(list, 2 * n);
+            shrink_to_fit(list);
+        }
+        resize_ns += now_ns() - start;
+        freeArrayList(list);
+    }
+    printf("%-8s %12zu %14.2f %18.2f\n", mmap_threshold != 0 ? "mremap" : "realloc", n,
+           fill_ns / (double)(rounds * n), resize_ns / (double)(rounds * 8) / 1e3);
+}
+
+int main(const int argc, char **argv) {
+    const size_t max_elements = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000000;
+    printf("%-8s %12s %14s %18s\n", "path", "elements", "fill ns/elem", "resize us/call");
+    for (size_t n = 1000; n <= max_elements; n *= 10) {
+        run(n, 0);
+        run(n, 1);
+    }
+    return 0;
+}
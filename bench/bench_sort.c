@@ -0,0 +1,100 @@
+/**
+ * @file bench_sort.c
+ * @brief Compares sort(), stable_sort(), an ARRAYLIST_DEFINE_SORT instance and qsort.
+ *
+ * Every sort orders the same list of pointers to ints, starting from
+ * random, sorted, reversed and few-unique (16 distinct values) inputs.
+ * qsort sorts the slots through an adapter dereferencing them, like the
+ * comparator passed to sort(); the template instance compares the ints
+ * inline.
+ *
+ * Usage: bench_sort [elements], default 1000000.
+ */
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+#include "ArrayList.h"
+#include "ArrayListSortTemplate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    const int x = *(const int *)a;
+    const int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_slots(const void *a, const void *b) {
+    return compare_ints(*(void *const *)a, *(void *const *)b);
+}
+
+#define INT_PTR_LESS(a, b, ctx) (*(const int *)(a) < *(const int *)(b))
+ARRAYLIST_DEFINE_SORT(int_ptr_sort, void *, INT_PTR_LESS)
+
+typedef enum { SORT, STABLE_SORT, TEMPLATE, QSORT } Method;
+
+static const char *const METHOD_NAMES[] = {"sort", "stable_sort", "template", "qsort"};
+
+/**
+ * @brief Sorts a copy of `input` with `method` and returns the elapsed time in ms.
+ */
+static double time_sort(ArrayList *list, void *const *input, const Method method) {
+    memcpy(list->arr, input, list->n * sizeof(void *));
+    mark_modified(list);
+    const double start = now_ns();
+    switch (method) {
+        case SORT: sort(list, compare_ints); break;
+        case STABLE_SORT: stable_sort(list, compare_ints); break;
+        case TEMPLATE: int_ptr_sort(list->arr, list->n, NULL); break;
+        case QSORT: qsort(list->arr, list->n, sizeof(void *), compare_slots); break;
+    }
+    const double elapsed = (now_ns() - start) / 1e6;
+    for (size_t i = 1; i < list->n; i++) {
+        if (compare_ints(list->arr[i - 1], list->arr[i]) > 0) {
+            fprintf(stderr, "%s left the list unsorted\n", METHOD_NAMES[method]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return elapsed;
+}
+
+int main(const int argc, char **argv) {
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    static const char *const INPUT_NAMES[] = {"random", "sorted", "reversed", "few-unique"};
+    int *values = malloc(n * sizeof(int));
+    void **input = malloc(n * sizeof(void *));
+    if (values == NULL || input == NULL) return EXIT_FAILURE;
+    ArrayList *list = init(n);
+    for (size_t i = 0; i < n; i++) push_back(list, NULL);
+
+    printf("%-11s", "input");
+    for (int m = 0; m < 4; m++) printf(" %12s", METHOD_NAMES[m]);
+    printf("   (ms, %zu elements)\n", n);
+    srand(42);
+    for (int kind = 0; kind < 4; kind++) {
+        for (size_t i = 0; i < n; i++) {
+            switch (kind) {
+                case 0: values[i] = rand(); break;
+                case 1: values[i] = (int)i; break;
+                case 2: values[i] = (int)(n - i); break;
+                default: values[i] = rand() % 16; break;
+            }
+            input[i] = &values[i];
+        }
+        printf("%-11s", INPUT_NAMES[kind]);
+        for (int m = 0; m < 4; m++) printf(" %12.2f", time_sort(list, input, (Method)m));
+        printf("\n");
+    }
+    freeArrayList(list);
+    free(input);
+    free(values);
+    return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file test_arraylist.c
+ * @brief Regression checks for the core ArrayList operations.
+ */
+
+#include "ArrayList.h"
+#include <assert.h>
+#include <stdio.h>
+
+/**
+ * @brief Appends slices of the list to itself while it is full.
+ *
+ * The slice lives in the buffer that growth reallocates.
+ */
+static void push_back_many_from_itself(void) {
+    ArrayList *list = init(2);
+    push_back(list, (void *)1);
+    push_back(list, (void *)2);
+    for (int round = 0; round < 5; round++) {
+        push_back_many(list, (const void **)list->arr, list->n);
+    }
+    assert(list->n == 64);
+    for (size_t i = 0; i < list->n; i++) {
+        assert(list->arr[i] == (void *)(i % 2 + 1));
+    }
+    shrink_to_fit(list);
+    push_back_many(list, (const void **)&list->arr[1], 1);
+    assert(list->n == 65 && list->arr[64] == (void *)2 && list->arr[65] == NULL);
+    freeArrayList(list);
+}
+
+int main(void) {
+    push_back_many_from_itself();
+    puts("test_arraylist: ok");
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file test_capacity_overflow.c
+ * @brief Checks that capacities whose byte size overflows are rejected.
+ *
+ * Each case is expected to terminate the process through THROW_ERROR
+ * with "capacity too large" instead of allocating a truncated buffer;
+ * ctest runs every case as a separate test matching that message.
+ */
+
+#include "ArrayList.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HUGE_CAPACITY ((size_t)1 << 61)
+
+static size_t huge_growth(const size_t length, const size_t required, void *ctx) {
+    (void)length;
+    (void)required;
+    (void)ctx;
+    return HUGE_CAPACITY;
+}
+
+/**
+ * @brief Fills a list with `policy` until it has to grow.
+ */
+static void grow_with(const ArrayListGrowthPolicy *policy) {
+    ArrayList *list = init(1);
+    set_growth_policy(list, policy);
+    for (int i = 0; i < 3; i++) push_back(list, NULL);
+}
+
+int main(const int argc, char **argv) {
+    const char *name = argc > 1 ? argv[1] : "";
+    if (strcmp(name, "init") == 0) {
+        ArrayList *list = init(HUGE_CAPACITY);
+        push_back(list, NULL);
+        push_back(list, NULL);
+    } else if (strcmp(name, "reserve") == 0) {
+        ArrayList *list = init(0);
+        reserve(list, HUGE_CAPACITY);
+        push_back(list, NULL);
+        push_back(list, NULL);
+    } else if (strcmp(name, "callback") == 0) {
+        grow_with(&(ArrayListGrowthPolicy){.kind = ARRAYLIST_GROWTH_CALLBACK, .callback = huge_growth});
+    } else if (strcmp(name, "additive") == 0) {
+        grow_with(&(ArrayListGrowthPolicy){.kind = ARRAYLIST_GROWTH_ADDITIVE, .increment = SIZE_MAX});
+    } else if (strcmp(name, "geometric") == 0) {
+        grow_with(&(ArrayListGrowthPolicy){.kind = ARRAYLIST_GROWTH_GEOMETRIC, .factor = 1e30});
+    } else {
+        fprintf(stderr, "unknown case: %s\n", name);
+        return 0;
+    }
+    puts("huge capacity accepted");
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file test_hash_index.c
+ * @brief Checks find() through an attached hash index after every mutation.
+ */
+
+#include "ArrayList.h"
+#include <assert.h>
+#include <stdio.h>
+
+#define VALUES 64
+
+static int values[VALUES];
+static size_t hash_calls;
+
+static uint64_t hash_int(const void *element) {
+    hash_calls++;
+    return (uint64_t)*(const int *)element % 7; // Few buckets, so probe runs are long
+}
+
+static int compare_ints(const void *a, const void *b) {
+    const int x = *(const int *)a;
+    const int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Same ordering as compare_ints(), but a different function, so find() scans linearly.
+ */
+static int compare_ints_linear(const void *a, const void *b) {
+    return compare_ints(a, b);
+}
+
+static bool is_odd(const void *element, void *ctx) {
+    (void)ctx;
+    return *(const int *)element % 2 != 0;
+}
+
+/**
+ * @brief Checks that the hash index finds the same first index as a linear scan for every value.
+ */
+static void check(const ArrayList *list, const char *step) {
+    for (int i = 0; i < VALUES; i++) {
+        if (find(list, &values[i], compare_ints) != find(list, &values[i], compare_ints_linear)) {
+            fprintf(stderr, "hash index out of sync after %s\n", step);
+            assert(false);
+        }
+    }
+}
+
+static const void *element(const int value) {
+    return &values[value];
+}
+
+int main(void) {
+    for (int i = 0; i < VALUES; i++) values[i] = i;
+    ArrayList *list = init(0);
+    for (int i = 0; i < 40; i++) push_back(list, element(i % 20));
+    attach_hash_index(list, hash_int, compare_ints);
+    check(list, "attach_hash_index");
+
+    // Bulk insertions update the index incrementally, hashing only the new elements.
+    const void *batch[] = {element(40), element(41), element(3), element(42)};
+    hash_calls = 0;
+    push_back_many(list, batch, 4);
+    assert(hash_calls == 4);
+    check(list, "push_back_many");
+
+    hash_calls = 0;
+    insert_range(list, 5, batch, 4);
+    assert(hash_calls == 4);
+    check(list, "insert_range in the middle");
+    insert_range(list, list->n, batch, 2);
+    check(list, "insert_range at the end");
+    insert_range(list, 0, batch, 1);
+    check(list, "insert_range at the front");
+
+    const size_t positions[] = {0, 0, 7, 30, list->n};
+    const void *scattered[] = {element(50), element(51), element(52), element(7), element(53)};
+    hash_calls = 0;
+    insert_indices(list, positions, scattered, 5);
+    assert(hash_calls == 5);
+    check(list, "insert_indices");
+
+    ArrayList *other = init(0);
+    push_back(other, element(60));
+    push_back(other, element(0));
+    hash_calls = 0;
+    append_list(list, other);
+    assert(hash_calls == 2);
+    check(list, "append_list");
+    append_list(list, list);
+    check(list, "append_list of itself");
+    freeArrayList(other);
+
+    // Single-element mutations.
+    insert_at(list, element(61), 3);
+    check(list, "insert_at");
+    remove_at(list, 10);
+    check(list, "remove_at");
+    swap_remove_at(list, 2);
+    check(list, "swap_remove_at");
+    pop_back(list);
+    check(list, "pop_back");
+
+    // Bulk removals and reorderings rebuild the index.
+    const size_t removed[] = {1, 4, 4, 20};
+    remove_indices(list, removed, 4);
+    check(list, "remove_indices");
+    remove_range(list, 5, 15);
+    check(list, "remove_range");
+    erase_if(list, is_odd, NULL);
+    check(list, "erase_if");
+    sort(list, compare_ints_linear);
+    check(list, "sort");
+    list->arr[0] = (void *)element(63);
+    mark_modified(list);
+    check(list, "mark_modified");
+
+    freeArrayList(list);
+    puts("test_hash_index: ok");
+    return 0;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file test_reserved.c
+ * @brief Regression checks for lists backed by a reserved address range.
+ */
+
+#include "ArrayList.h"
+#include <assert.h>
+#include <stdio.h>
+
+/**
+ * @brief Fills a reserved list up to exactly `max_length` elements.
+ *
+ * Geometric growth overshoots the reservation well before it is full, so
+ * this only passes if growth is capped at the reserved capacity.
+ */
+static void fill_to_max_length(const size_t length, const size_t max_length) {
+    ArrayList *list = init_reserved(length, max_length);
+    void **const arr = list->arr;
+    for (size_t i = 0; i < max_length; i++) {
+        push_back(list, (void *)(i + 1));
+    }
+    assert(get_number_of_elements(list) == max_length);
+    assert(list->arr == arr); // Growing never moves a reserved buffer
+    assert(list->arr[max_length] == NULL);
+    for (size_t i = 0; i < max_length; i++) {
+        assert(list->arr[i] == (void *)(i + 1));
+    }
+    freeArrayList(list);
+}
+
+int main(void) {
+    fill_to_max_length(0, 100000);
+    fill_to_max_length(16, 65536);
+    fill_to_max_length(1, 1);
+    puts("test_reserved: ok");
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file test_small.c
+ * @brief Regression checks for lists whose first slots follow the structure.
+ */
+
+#include "ArrayList.h"
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+
+static int compare_ptrs(const void *a, const void *b) {
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Checks that `list` holds 1..n and is terminated.
+ */
+static void check_contents(const ArrayList *list, const size_t n) {
+    assert(get_number_of_elements(list) == n);
+    for (size_t i = 0; i < n; i++) {
+        assert(list->arr[i] == (void *)(i + 1));
+    }
+    assert(list->arr[n] == NULL);
+}
+
+/**
+ * @brief Fills a stack-declared small list past its inline slots.
+ *
+ * The list must not allocate anything while it fits inline.
+ */
+static void stack_small_list(void) {
+    ARRAYLIST_SMALL(4) small;
+    static_assert(offsetof(ARRAYLIST_SMALL(4), slots) < 64, "inline slots start past the first cache line");
+    ArrayList *list = ARRAYLIST_SMALL_INIT(small);
+    assert(list == &small.list);
+    for (size_t i = 0; i < 4; i++) {
+        push_back(list, (void *)(i + 1));
+    }
+    assert(list->arr == small.slots);
+    assert(list->extension == NULL);
+    assert(find(list, (void *)3, compare_ptrs) == 2);
+    for (size_t i = 4; i < 100; i++) {
+        push_back(list, (void *)(i + 1));
+    }
+    assert(list->arr != small.slots);
+    check_contents(list, 100);
+    freeArrayList(list);
+}
+
+/**
+ * @brief Fills an init_small() list past its inline slots, with and without cold state.
+ */
+static void heap_small_list(const bool sorted) {
+    ArrayList *list = init_small(8);
+    assert(list->arr == (void **)(list + 1));
+    if (sorted) sort(list, compare_ptrs);
+    for (size_t i = 0; i < 50; i++) {
+        push_back(list, (void *)(i + 1));
+    }
+    check_contents(list, 50);
+    if (sorted) assert(is_sorted(list, compare_ptrs));
+    freeArrayList(list);
+}
+
+int main(void) {
+    static_assert(sizeof(ArrayList) <= 48, "ArrayList header grew");
+    stack_small_list();
+    heap_small_list(false);
+    heap_small_list(true);
+    puts("test_small: ok");
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file test_sort.c
+ * @brief Regression checks for the sorts.
+ */
+
+#include "ArrayList.h"
+#include <assert.h>
+#include <stdio.h>
+
+#define KEPT 90
+#define REMOVED 10
+
+static int compare_ints(const void *a, const void *b) {
+    const int x = *(const int *)a;
+    const int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t hash_int(const void *element) {
+    return (uint64_t)*(const int *)element;
+}
+
+static uint32_t key_u32(const void *element) {
+    return (uint32_t)*(const int *)element;
+}
+
+/**
+ * @brief Builds a shuffled list of 0..KEPT-1 whose Bloom filter also saw KEPT..KEPT+REMOVED-1.
+ *
+ * Removals leave their bits set, so as long as the filter is not rebuilt
+ * it never rejects the removed values.
+ */
+static ArrayList *list_with_filter(int *values) {
+    ArrayList *list = init(0);
+    attach_bloom_filter(list, hash_int, compare_ints, 10);
+    for (int i = 0; i < KEPT + REMOVED; i++) {
+        values[i] = i < KEPT ? (i * 37) % KEPT : i;
+        push_back(list, &values[i]);
+    }
+    for (int i = 0; i < REMOVED; i++) pop_back(list);
+    return list;
+}
+
+/**
+ * @brief Checks that a sort left the elements in order and the Bloom filter untouched.
+ *
+ * Sorting permutes the elements without changing the set, so the filter
+ * must not be rebuilt; a rebuild would start rejecting the removed values.
+ */
+static void check_sorted_and_filter_kept(ArrayList *list) {
+    assert(list->n == KEPT);
+    for (size_t i = 0; i < list->n; i++) {
+        assert(*(int *)list->arr[i] == (int)i);
+    }
+    reset_bloom_filter_stats(list);
+    for (int i = KEPT; i < KEPT + REMOVED; i++) {
+        assert(find(list, &i, compare_ints) == -1);
+    }
+    const ArrayListBloomStats stats = get_bloom_filter_stats(list);
+    assert(stats.lookups == REMOVED);
+    assert(stats.rejections == 0);
+    assert(stats.false_positives == REMOVED);
+    freeArrayList(list);
+}
+
+int main(void) {
+    int values[KEPT + REMOVED];
+    ArrayList *list = list_with_filter(values);
+    sort(list, compare_ints);
+    check_sorted_and_filter_kept(list);
+
+    list = list_with_filter(values);
+    stable_sort(list, compare_ints);
+    check_sorted_and_filter_kept(list);
+
+    list = list_with_filter(values);
+    sort_by_key_u32(list, key_u32);
+    check_sorted_and_filter_kept(list);
+
+    puts("test_sort: ok");
+    return 0;
+}
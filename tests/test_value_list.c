@@ -0,0 +1,49 @@
+/**
+ * @file test_value_list.c
+ * @brief Regression checks for ValueList.
+ */
+
+#include "ValueList.h"
+#include <assert.h>
+#include <stdio.h>
+
+/**
+ * @brief Pushes and inserts elements of the list itself while it is full.
+ *
+ * The source element lives in the buffer that growth reallocates and, for
+ * inserts, in the range the shift moves.
+ */
+static void self_referencing_elements(void) {
+    ValueList *list = value_list_init(sizeof(int), 1);
+    const int first = 7;
+    value_list_push_back(list, &first);
+    for (int i = 0; i < 10; i++) {
+        value_list_push_back(list, value_list_at(list, 0));
+    }
+    for (size_t i = 0; i < list->n; i++) {
+        assert(*(int *)value_list_at(list, i) == 7);
+    }
+
+    value_list_free(list);
+
+    list = value_list_init(sizeof(int), 3);
+    for (int i = 0; i < 3; i++) value_list_push_back(list, &i);
+    // Source after the insertion point: it is shifted right before the copy.
+    value_list_insert_at(list, value_list_at(list, 2), 0);
+    assert(*(int *)value_list_at(list, 0) == 2);
+    // Source before the insertion point stays in place.
+    value_list_insert_at(list, value_list_at(list, 1), 3);
+    assert(*(int *)value_list_at(list, 3) == 0);
+    const int expected[] = {2, 0, 1, 0, 2};
+    assert(list->n == 5);
+    for (size_t i = 0; i < 5; i++) {
+        assert(*(int *)value_list_at(list, i) == expected[i]);
+    }
+    value_list_free(list);
+}
+
+int main(void) {
+    self_referencing_elements();
+    puts("test_value_list: ok");
+    return 0;
+}